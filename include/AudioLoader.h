@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+class AudioPlayer;
+
+enum AudioLoadState : uint8_t {
+  LOAD_PROGRESS,
+  LOAD_DONE,
+  LOAD_FAILED,
+  LOAD_CANCELLED
+};
+
+struct AudioLoadStatus {
+  const char *folder;
+  AudioLoadState state;
+  uint8_t loaded;     // cell yang sudah dibaca
+  uint8_t total;      // jumlah file .raw di folder
+};
+
+// Dipanggil dari loader task, jangan blocking lama
+typedef void (*AudioLoadCallback)(const AudioLoadStatus &status);
+
+// Satu request di queue loader
+struct AudioLoadJob {
+  char folder[AUDIO_LOADER_PATH_MAX];
+  uint32_t seq;       // 0 = preload (tidak bisa di-cancel)
+};
+
+// Loader register di background. Tombol (ADC task) dan command BLE cukup
+// kirim request lalu kembali; baca file + isi cache dikerjakan loader
+// task sementara bank lama tetap diputar. Request load yang lebih baru
+// membatalkan yang sedang jalan (dicek per file). Preload masuk belakang
+// queue, load register masuk depan.
+class AudioLoader {
+public:
+  AudioLoader();
+
+  bool begin(AudioPlayer *audioPlayer);
+  void setCallback(AudioLoadCallback cb) { callback = cb; }
+
+  bool request(const char *folderPath);
+  bool preload(const char *folderPath);
+
+  bool isCancelled(const AudioLoadJob &job) const {
+    return job.seq != 0 && job.seq != latestSeq;
+  }
+  void reportProgress(const AudioLoadJob &job, uint8_t loaded, uint8_t total);
+
+  static void loaderTaskWrapper(void *parameter);
+
+private:
+  void loaderTask();
+  bool enqueue(const char *folderPath, uint32_t seq);
+  void notify(const AudioLoadJob &job, AudioLoadState state, uint8_t loaded, uint8_t total);
+
+  AudioPlayer *player = nullptr;
+  AudioLoadCallback callback = nullptr;
+  QueueHandle_t queue = nullptr;
+  TaskHandle_t loaderTaskHandle = nullptr;
+  volatile uint32_t latestSeq = 0;
+  portMUX_TYPE seqMux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern AudioLoader audioLoader;
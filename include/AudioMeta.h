@@ -2,6 +2,13 @@
 #define AUDIO_META_H
 
 #include <Arduino.h>
+#include "EnvelopeEngine.h"
+#include "VehicleModel.h"
+#include "AutoShift.h"
+
+// Encoding data audio setelah header ("format" di header JSON)
+#define AUDIO_FORMAT_PCM8   0   // 1 byte per sample (default)
+#define AUDIO_FORMAT_ADPCM  1   // IMA-ADPCM 4-bit blok (lihat ImaAdpcm.h)
 
 struct AudioMeta {
     String title;
@@ -14,6 +21,21 @@ struct AudioMeta {
 
     uint32_t sample_rate;
     uint32_t sample_engine_rpm;
+    uint8_t load;            // 1 = on-throttle, 0 = off-throttle (decel)
+    bool normalized;         // data sudah dinormalisasi saat upload
+    uint32_t loopStart;      // titik loop dalam sample (loopEnd 0 = belum dianalisis)
+    uint32_t loopEnd;
+
+    uint8_t format;          // AUDIO_FORMAT_*
+    uint32_t blockBytes;     // ukuran blok ADPCM ("block")
+    uint32_t sampleCount;    // jumlah sample setelah decode
+
+    bool granular;           // "mode":"granular" (default "resample")
+    uint8_t cycleRevs;       // putaran per siklus pembakaran: 2 = 4-tak, 1 = 2-tak
+
+    EnvCurveSet envelopes;   // kurva rev/shift "env_*" (mask 0 = pakai bawaan)
+    VehicleParams vehicle;   // drivetrain (rentang RPM + "gear_ratios", "rev_rate", ...)
+    ShiftSchedule shifts;    // tabel auto shift "shift_up"/"shift_down" (mask 0 = bawaan)
 
     uint32_t dataOffset;
     uint32_t dataLength;
@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+
+struct AudioMeta;
+
+// Normalisasi PCM 8-bit sekali jalan saat upload (atau lazy saat load
+// pertama), hasilnya ditulis balik ke file dengan flag "normalized":1 di
+// header JSON. Load berikutnya tinggal baca data tanpa proses per-sample.
+// Titik loop seamless (LoopAnalyzer) dicari di langkah yang sama dan
+// disimpan sebagai "loop_start"/"loop_end".
+//
+// Range output 19-237, centered di 127. Kernel di PCMNormalize.
+//
+// Dipanggil dari BLE task (upload) dan loader task (lazy): semua baca/tulis
+// balik file diserialkan satu mutex, pemegangnya juga pemilik chunk buffer
+// dan file .norm sementara. File dicek ulang setelah lock, jadi yang kedua
+// tidak menulis ulang hasil yang pertama.
+class AudioNormalizer {
+public:
+  static void begin();
+
+  // Normalisasi file di LittleFS (2 pass, chunked - RAM tetap kecil)
+  static bool normalizeFile(const char *path);
+
+  // Normalisasi + cari titik loop buffer yang sudah di RAM (yang belum),
+  // update `meta`, lalu tulis balik ke file
+  static bool prepareAndWriteBack(const char *path, AudioMeta &meta,
+                                  uint8_t *data, size_t length);
+
+private:
+  static bool normalizeLocked(const char *path);
+  static void findLoopInFile(File &src, AudioMeta &meta, const uint8_t lut[256]);
+  static String buildHeader(const char *path, const AudioMeta &meta);
+  static bool replaceFile(const String &tmpPath, const char *path);
+};
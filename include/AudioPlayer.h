@@ -2,40 +2,75 @@
 #include <Arduino.h>
 #include <FS.h>
 #include <LittleFS.h>
+#include "EngineSoundBank.h"
 
 class VolumeControl;
+class AudioSink;
+struct AudioMeta;
+struct AudioLoadJob;
 
 class AudioPlayer {
 public:
   AudioPlayer();
 
   void begin();
-  bool loadFile(const char *path);
+  bool loadRegister(const char *folderPath, const AudioLoadJob *job = nullptr);
+  bool preloadRegister(const char *folderPath);
   void startPlayback();
   void stopPlayback();
+  void stopEngine();
 
   void setSampleRate(uint32_t rate);
   void updateSampleRateFromADC(int adcValue);
+  void setEngineRPM(uint32_t rpm);
+  void setEngineLoad(uint8_t load);
+  uint32_t getEngineRPM();
+  uint8_t getActiveVoices();
 
   void mute(bool m);
   void toggleMute();
   bool isPlaying();
   uint32_t getSampleRate();
+  bool isStreaming() { return streaming; }
+  uint32_t getUnderrunCount();
+  uint32_t getOutputUnderruns();
 
-  static void IRAM_ATTR onTimerISR();
+  const char *getOutputBackend();
+
+  // Render callback untuk AudioSink: mix + resample + volume per blok
+  static void IRAM_ATTR renderSamples(uint8_t *out, size_t count);
 
 private:
-  void normalizePCM8(uint8_t *data, size_t length);
-  void cleanupAudioBuffer();
+  static void IRAM_ATTR renderStream(int16_t *out, size_t count);
+  static void IRAM_ATTR renderSwapFade(EngineSoundBank *bank, int16_t *out, size_t count);
+  static void IRAM_ATTR applyEngineFade(int16_t *out, size_t count);
+  uint8_t scanRegister(const char *folderPath, String *paths);
+  bool fillBank(EngineSoundBank &bank, String *paths, uint8_t count, const AudioLoadJob *job);
+  void activateBank(EngineSoundBank *bank);
+  bool startSynth(const char *folderPath);
+  bool streamRegister(const char *path, const AudioMeta &meta);
+  bool loadCell(const char *path, AudioMeta &meta, EngineSoundBank &bank);
   bool isValidFileSize(uint32_t size, uint32_t maxSize);
-  bool allocateBuffer();
-  bool readFileData(File& audioFile);
-  bool restoreTimer(bool success);
-
-  static hw_timer_t *timer;
-  static uint8_t *audioBuffer;
-  static uint32_t audioLength;
-  static volatile uint32_t index;
+  bool readFileData(File& audioFile, uint8_t *buffer, uint32_t length);
+  bool readAdpcmData(File& audioFile, const AudioMeta &meta, uint8_t *buffer);
+  bool restoreOutput(bool success);
+  bool startStreaming(const char *path, const AudioMeta &meta);
+  void stopStreaming();
+  void applyPitch();
+  static uint32_t rateToPhaseIncrement(uint32_t rate);
+  static uint32_t clampRate(uint64_t rate);
+
+  static AudioSink *sink;
+  static volatile uint32_t phaseFrac;       // fraksi posisi (16 bit bawah)
+  static volatile uint32_t phaseIncrement;  // 16.16, ditulis atomik dari task
+  static volatile bool streaming;           // true = sumber dari AudioStreamer
+  static volatile bool engineOn;            // false = hanya efek one-shot
+  static int32_t engineLevel;               // fade engine on/off (Q15, render)
+  static volatile bool synthActive;         // register kosong, sumber EngineSynth
   static uint32_t currentSampleRate;
+  static uint32_t engineRPM;                // dari VehicleModel, 0 = ikut rate
+  static uint32_t streamRefRPM;             // meta file yang sedang di-stream
+  static uint32_t streamSampleRate;
+  static uint8_t currentLoad;               // diterapkan ke bank saat diaktifkan
   static VolumeControl* volumeCtrl;
 };
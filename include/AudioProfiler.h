@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+class AudioSink;
+
+// Profiler ISR sample + render blok dalam cycle CPU (CCOUNT). Semua
+// pengukuran di core yang sama dengan yang diukur (ISR timer di core
+// yang memanggil sink begin, render task di AUDIO_TASK_CORE), jadi
+// selisih CCOUNT valid. AUDIO_PROFILER 0 menghapus semuanya: macro jadi
+// kosong dan class ini tidak ikut dikompilasi.
+#if AUDIO_PROFILER
+
+#define AUDIO_PROFILE_ISR_BEGIN()    uint32_t profIsrStart = ESP.getCycleCount()
+#define AUDIO_PROFILE_ISR_END()      audioProfiler.endIsr(profIsrStart)
+#define AUDIO_PROFILE_RENDER_BEGIN() uint32_t profRenderStart = ESP.getCycleCount()
+#define AUDIO_PROFILE_RENDER_END()   audioProfiler.endRender(profRenderStart)
+
+// min/avg/max + histogram log2 (bucket n = n bit, 2^(n-1) .. 2^n - 1 cycle)
+struct CycleStats {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  uint32_t hist[33];
+
+  void IRAM_ATTR add(uint32_t cycles);
+  void clear();
+};
+
+class AudioProfiler {
+public:
+  AudioProfiler();
+
+  void begin(AudioSink *outputSink, uint32_t sampleRate);
+
+  void IRAM_ATTR endIsr(uint32_t startCycles);
+  void IRAM_ATTR endRender(uint32_t startCycles);
+
+  String report();
+  void printReport();
+  void reset();
+
+private:
+  AudioSink *sink = nullptr;
+  uint32_t cpuMHz = 240;
+  uint32_t periodCycles = 0;    // satu periode sample
+  uint32_t blockCycles = 0;     // satu blok AUDIO_BLOCK_SAMPLES
+
+  CycleStats isr;
+  CycleStats render;
+  uint32_t lastIsrStart = 0;
+  uint32_t latePeriods = 0;     // ISR masuk > 1.5 periode setelah sebelumnya
+  uint32_t missedPeriods = 0;   // perkiraan periode yang terlewat
+  uint32_t renderOverruns = 0;  // render satu blok lebih lama dari durasinya
+  uint32_t underrunBase = 0;    // underrun sink saat reset
+  int64_t resetTime = 0;        // us, esp_timer
+};
+
+extern AudioProfiler audioProfiler;
+
+#else
+
+#define AUDIO_PROFILE_ISR_BEGIN()    ((void)0)
+#define AUDIO_PROFILE_ISR_END()      ((void)0)
+#define AUDIO_PROFILE_RENDER_BEGIN() ((void)0)
+#define AUDIO_PROFILE_RENDER_END()   ((void)0)
+
+#endif
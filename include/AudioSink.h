@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Callback render: isi `count` sample PCM 8-bit unsigned (center 128).
+// Dipanggil dari render task milik sink, satu blok AUDIO_BLOCK_SAMPLES
+// per panggilan. Tidak pernah dari ISR.
+typedef void (*AudioRenderFn)(uint8_t *out, size_t count);
+
+// Backend output audio. Sink menarik sample dari render callback dengan
+// rate tetap; AudioPlayer tidak tahu apakah blok diputar oleh timer ISR
+// atau DMA I2S. Header ini sengaja tanpa Arduino.h supaya
+// mock di host bisa implement interface yang sama.
+class AudioSink {
+public:
+  virtual ~AudioSink() {}
+
+  virtual bool begin(uint32_t sampleRate, AudioRenderFn render) = 0;
+  virtual void end() = 0;
+
+  // pause() harus menunggu render yang sedang jalan selesai, setelah itu
+  // sink output silence sampai resume(). Dipakai saat buffer audio diganti.
+  virtual void pause() = 0;
+  virtual void resume() = 0;
+
+  virtual uint32_t getSampleRate() const = 0;
+  virtual uint32_t getUnderruns() const { return 0; }  // blok telat dirender
+  virtual const char *name() const = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include "config.h"
+
+// Streaming playback: reader task mengisi ring buffer SPSC dari LittleFS,
+// render task mengkonsumsi dari ring. Loop ditangani reader dengan seek balik ke
+// titik loop (loop_start), jadi RAM yang dipakai tetap AUDIO_RING_CAPACITY berapapun
+// ukuran file.
+//
+// Producer = reader task (tulis head), consumer = render (tulis tail).
+// head/tail free-running 32-bit, index ring = counter & mask.
+//
+// Aset ADPCM: ring berisi blok terkompresi (2x durasi per byte), render
+// men-decode blok ke FIFO PCM kecil (decodeAhead) lalu baca dari situ.
+class AudioStreamer {
+public:
+  AudioStreamer();
+
+  bool begin();
+  bool start(const char *path, uint32_t dataOffset, uint32_t dataLength,
+             uint32_t loop = 0, uint32_t adpcmBlock = 0);
+  void stop();
+  bool isActive() { return active; }
+
+  // ===== Consumer side (render) =====
+  inline uint32_t IRAM_ATTR available() const {
+    return blockBytes ? pcmHead - pcmTail : head - tail;
+  }
+  inline uint8_t IRAM_ATTR peek(uint32_t offset) const {
+    if (blockBytes) return pcm[(pcmTail + offset) & (AUDIO_ADPCM_FIFO - 1)];
+    return ring[(tail + offset) & (AUDIO_RING_CAPACITY - 1)];
+  }
+  inline void IRAM_ATTR consume(uint32_t count) {
+    if (blockBytes) pcmTail += count; else tail += count;
+  }
+  void IRAM_ATTR decodeAhead(uint32_t needed);
+  inline void IRAM_ATTR noteUnderrun() { underruns++; }
+
+  uint32_t getUnderruns() { return underruns; }
+  uint32_t getRefillCount() { return refills; }
+  void resetStats();
+
+  static void readerTaskWrapper(void *parameter);
+
+private:
+  void readerTask();
+  bool fillChunk();
+  uint32_t freeSpace() const { return AUDIO_RING_CAPACITY - (head - tail); }
+
+  uint8_t *ring = nullptr;
+  volatile uint32_t head = 0;
+  volatile uint32_t tail = 0;
+
+  // ADPCM (blockBytes 0 = PCM8): FIFO hasil decode, hanya disentuh render
+  uint32_t blockBytes = 0;
+  uint8_t *pcm = nullptr;
+  uint8_t *decodeBuf = nullptr;
+  uint32_t pcmHead = 0;
+  uint32_t pcmTail = 0;
+  volatile bool active = false;
+
+  volatile uint32_t underruns = 0;
+  uint32_t refills = 0;
+  uint32_t reportedUnderruns = 0;
+  unsigned long lastReport = 0;
+
+  File file;
+  uint32_t dataOffset = 0;
+  uint32_t dataLength = 0;
+  uint32_t loopStart = 0;  // setelah dataLength, lanjut baca dari sini
+  uint32_t dataPos = 0;    // posisi baca relatif ke dataOffset
+
+  SemaphoreHandle_t fileMutex = nullptr;
+  TaskHandle_t readerTaskHandle = nullptr;
+};
+
+extern AudioStreamer audioStreamer;
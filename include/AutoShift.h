@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Tabel shift dari metadata aset. Baris = gigi saat ini (baris 0 = gigi 1),
+// kolom = posisi throttle 0..100% rata (AUTOSHIFT_THROTTLE_BINS). Nilai RPM.
+// Bit 0 mask = up diisi, bit 1 = down diisi; yang kosong pakai bawaan.
+struct ShiftSchedule {
+  uint8_t mask;
+  uint16_t up[VEHICLE_MAX_GEARS][AUTOSHIFT_THROTTLE_BINS];    // naik dari gigi ini
+  uint16_t down[VEHICLE_MAX_GEARS][AUTOSHIFT_THROTTLE_BINS];  // turun dari gigi ini
+};
+
+#define SHIFT_SCHEDULE_UP    0x01
+#define SHIFT_SCHEDULE_DOWN  0x02
+
+// Transmisi otomatis berbasis tabel di atas VehicleModel, dievaluasi per
+// AUTOSHIFT_TICK_MS dengan integer saja (interpolasi throttle Q12):
+//   - upshift saat RPM >= up[gigi][throttle], downshift saat <= down
+//   - histeresis: titik downshift dipaksa di bawah RPM hasil upshift dari
+//     gigi bawahnya (rasio model) minus AUTOSHIFT_HYST_RPM, jadi tidak bolak-balik
+//   - dwell: tidak ada shift otomatis AUTOSHIFT_MIN_DWELL_MS setelah shift
+//     apapun (termasuk manual) atau selama kopling masih bekerja
+//   - kickdown: throttle naik >= AUTOSHIFT_KICKDOWN_DELTA dalam
+//     AUTOSHIFT_KICKDOWN_MS -> turun ke gigi terendah yang tidak over-rev,
+//     boleh melewati dwell
+//
+// setSchedule() dari task loader, update() dari task kontrol.
+class AutoShift {
+public:
+  AutoShift();
+
+  void setSchedule(const ShiftSchedule *schedule);  // nullptr = bawaan
+  void setEnabled(bool on);
+  bool isEnabled() { return enabled; }
+  void noteShift(uint32_t nowMs) { lastShiftMs = nowMs; }
+
+  // Gigi tujuan kalau perlu pindah, 0 = tetap
+  uint8_t update(uint32_t nowMs);
+
+  static bool parseTable(const char *text, uint16_t table[][AUTOSHIFT_THROTTLE_BINS]);
+
+private:
+  void rebuild();
+  uint16_t lookup(const uint16_t *row, uint16_t throttle);
+
+  ShiftSchedule source;             // dari aset (mask = yang diisi)
+  ShiftSchedule active;             // lengkap, sudah diberi histeresis
+  volatile bool sourcePending = true;
+  uint32_t builtVersion = 0;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  volatile bool enabled = false;
+  uint32_t lastTick = 0;
+  uint32_t lastShiftMs = 0;
+  uint16_t history[AUTOSHIFT_KICKDOWN_MS / AUTOSHIFT_TICK_MS];  // throttle per tick
+  uint8_t historyPos = 0;
+};
+
+extern AutoShift autoShift;
@@ -5,6 +5,7 @@
 #define SERVICE_UUID        "12345678-1234-1234-1234-1234567890ab"
 #define CHARACTERISTIC_UUID "87654321-4321-4321-4321-0987654321ab"
 #define FILE_CHARACTERISTIC_UUID "87654321-4321-4321-4321-0987654321cd"
+#define DIAG_CHARACTERISTIC_UUID "87654321-4321-4321-4321-0987654321ef"  // read: laporan diagnostik (teks)
 
 // Command definitions untuk kontrol
 #define CMD_GEAR_UP          0x01
@@ -16,6 +17,7 @@
 #define CMD_REQ_FILE_INFO    0x14
 #define CMD_SET_AUDIO_PLAY   0x15
 #define CMD_TOGGLE_AUTO_SHIFT 0x16
+#define CMD_RESET_DIAG       0x17
 #define CMD_REQ_STATUS       0xFF
 
 // Command definitions untuk file transfer audio
@@ -64,6 +66,7 @@ public:
 private:
   static NimBLECharacteristic* pCharacteristic;
   static NimBLECharacteristic* pFileCharacteristic;
+  static NimBLECharacteristic* pDiagCharacteristic;
   static uint8_t pendingCommand;
   static uint8_t commandData[512];
   static size_t commandDataLen;
@@ -76,6 +79,7 @@ private:
   String originalFilename;
   File tmpFile;
   uint8_t currentRegister = 1;
+  QueueHandle_t normalizeQueue = nullptr;  // path file baru yang belum dinormalisasi (diproses di update)
   
   class ServerCallbacks : public NimBLEServerCallbacks {
     void onConnect(NimBLEServer* pServer);
@@ -89,6 +93,10 @@ private:
   class FileCharacteristicCallbacks : public NimBLECharacteristicCallbacks {
     void onWrite(NimBLECharacteristic* pCharacteristic);
   };
+  
+  class DiagCharacteristicCallbacks : public NimBLECharacteristicCallbacks {
+    void onRead(NimBLECharacteristic* pCharacteristic);
+  };
 };
 
 extern BLEControl ble;
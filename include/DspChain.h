@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+#define DSP_COEF_BITS 29   // koefisien biquad Q29 (range +-4)
+
+// Satu tahap pemrosesan in-place pada bus 16-bit, satu blok per panggilan
+class DspStage {
+public:
+  virtual ~DspStage() {}
+  virtual void IRAM_ATTR process(int16_t *buf, size_t count) = 0;
+};
+
+// Koefisien biquad ternormalisasi (a0 = 1), Q29
+struct BiquadCoeffs {
+  int32_t b0, b1, b2;
+  int32_t a1, a2;
+};
+
+// Biquad direct form I. Koefisien baru ditulis ke set cadangan lalu index
+// di-flip (32-bit atomik), render mengambil index sekali per blok, jadi
+// tidak pernah membaca set yang setengah ditulis.
+class BiquadStage : public DspStage {
+public:
+  BiquadStage();
+  void setCoeffs(const BiquadCoeffs &c);
+  void IRAM_ATTR process(int16_t *buf, size_t count) override;
+
+  // Desain RBJ (float, hanya untuk membangun tabel di luar render)
+  static BiquadCoeffs lowPass(float hz, float q);
+  static BiquadCoeffs highPass(float hz, float q);
+
+private:
+  BiquadCoeffs coeffs[2];
+  volatile uint32_t active = 0;
+  int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+  int64_t residue = 0;              // sisa kuantisasi, < 2^DSP_COEF_BITS
+};
+
+// Comb feedback pendek (resonansi knalpot). Delay pecahan Q8 dengan
+// interpolasi linear, di-slew per sample ke target supaya perubahan RPM
+// tidak zipper.
+class CombStage : public DspStage {
+public:
+  CombStage();
+  void setDelay(uint32_t delayQ8) { targetDelay = delayQ8; }
+  void setGains(int32_t feedbackQ15, int32_t mixQ15);
+  void IRAM_ATTR process(int16_t *buf, size_t count) override;
+
+private:
+  int16_t line[AUDIO_DSP_COMB_MAX];
+  uint32_t writePos = 0;
+  uint32_t delay;                 // Q8
+  volatile uint32_t targetDelay;  // Q8, ditulis dari task kontrol
+  int32_t feedback = 0;           // Q15
+  int32_t mix = 0;                // Q15
+};
+
+// Rantai tahap DSP untuk suara engine (sebelum efek one-shot dan volume).
+// Default: DC high-pass -> low-pass throttle -> comb knalpot. Update
+// kontrol (setLoad/setRPM) hanya memilih entry tabel yang sudah dihitung
+// di begin(), jadi biaya per sample tetap.
+class DspChain {
+public:
+  DspChain();
+
+  void begin();
+  bool add(DspStage *stage);
+  void setEnabled(bool enable) { enabled = enable; }
+  bool isEnabled() { return enabled; }
+
+  void setLoad(uint8_t load);     // 0-255, dari throttle
+  void setRPM(uint32_t rpm);
+
+  void IRAM_ATTR process(int16_t *buf, size_t count);
+
+private:
+  DspStage *stages[AUDIO_DSP_MAX_STAGES];
+  volatile uint8_t stageCount = 0;
+  volatile bool enabled = AUDIO_DSP_ENABLED;
+
+  BiquadStage dcBlock;
+  BiquadStage throttleLowPass;
+  CombStage exhaust;
+
+  BiquadCoeffs lowPassTable[AUDIO_DSP_LP_STEPS];
+  uint32_t combDelayTable[AUDIO_DSP_COMB_STEPS];   // Q8
+  uint8_t loadStep = 0xFF;
+  uint8_t rpmStep = 0xFF;
+};
+
+extern DspChain dspChain;
@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+
+class AudioSink;
+struct AudioMeta;
+
+// Jenis efek one-shot. File di-map dari prefix nama, boleh beberapa
+// varian per efek (pop1.raw, pop2.raw, ...) yang dipakai bergiliran.
+enum EffectId : uint8_t {
+  EFFECT_SHIFT_UP,     // /audio/shift/up*.raw
+  EFFECT_SHIFT_DOWN,   // /audio/shift/down*.raw
+  EFFECT_POP,          // /audio/effects/pop*.raw   (overrun saat rev stop)
+  EFFECT_START,        // /audio/effects/start*.raw (crank)
+  EFFECT_STOP,         // /audio/effects/stop*.raw  (shutdown)
+  EFFECT_COUNT
+};
+
+// Rekaman efek di dalam pool (PCM 8-bit, sudah di-decode)
+struct EffectSample {
+  EffectId id;
+  const uint8_t *data;
+  uint32_t length;
+  uint32_t phaseInc;    // 16.16, sample_rate rekaman -> AUDIO_OUTPUT_RATE
+};
+
+// Satu voice yang sedang bunyi (hanya disentuh dari konteks render)
+struct EffectVoice {
+  const EffectSample *sample;   // nullptr = voice bebas
+  uint32_t pos;
+  uint32_t frac;
+  int32_t gain;                 // Q15
+  uint32_t started;             // urutan trigger, untuk voice stealing
+};
+
+// Mixer efek one-shot polifonik di atas loop engine. Semua rekaman efek
+// dibaca ke satu pool yang dialokasi sekali saat boot, jadi trigger tidak
+// pernah alokasi atau baca flash. Trigger masuk antrian kecil dan baru
+// diambil render di awal blok; kalau semua voice terpakai, voice yang
+// paling lama dicuri.
+class EffectMixer {
+public:
+  EffectMixer();
+
+  void begin(AudioSink *outputSink);
+  void load();
+  void invalidate(const char *path);
+
+  // Dipanggil dari task kontrol (boleh lebih dari satu task)
+  bool trigger(EffectId id, uint8_t gain = 255);
+  bool hasEffect(EffectId id);
+  uint8_t getActiveVoices() { return activeVoices; }
+  bool isIdle() { return activeVoices == 0 && queueHead == queueTail; }
+
+  // Tambahkan semua voice aktif ke bus mix 16-bit (dari render)
+  void IRAM_ATTR render(int16_t *bus, size_t count);
+
+private:
+  struct EffectTrigger {
+    uint8_t sample;
+    uint8_t gain;
+  };
+
+  void loadFolder(const char *folder, const char *const *prefixes, const EffectId *ids, uint8_t kinds);
+  bool loadSample(const char *path, EffectId id);
+  bool readSample(File &f, const AudioMeta &meta, uint8_t *dst);
+  void IRAM_ATTR startQueued();
+
+  uint8_t *pool = nullptr;
+  uint32_t poolSize = 0;
+  uint32_t poolUsed = 0;
+
+  EffectSample samples[AUDIO_EFFECT_MAX_SAMPLES];
+  uint8_t sampleCount = 0;
+  uint8_t nextVariant[EFFECT_COUNT];
+
+  EffectVoice voices[AUDIO_EFFECT_VOICES];
+  volatile uint8_t activeVoices = 0;
+  uint32_t triggerCounter = 0;
+
+  EffectTrigger queue[AUDIO_EFFECT_QUEUE];
+  volatile uint32_t queueHead = 0;     // ditulis trigger()
+  volatile uint32_t queueTail = 0;     // ditulis render
+  portMUX_TYPE queueMux = portMUX_INITIALIZER_UNLOCKED;
+
+  AudioSink *sink = nullptr;
+};
+
+extern EffectMixer effectMixer;
@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "EnvelopeEngine.h"
+#include "VehicleModel.h"
+#include "AutoShift.h"
+
+struct AudioMeta;
+
+// Satu grain aktif mode granular: posisi baca sumber + posisi di jendela
+struct GrainVoice {
+  uint32_t pos;
+  uint32_t frac;
+  uint32_t phase;                 // 16.16 index tabel jendela, >= AUDIO_GRAIN_WINDOW = selesai
+  uint32_t phaseStep;
+};
+
+// Satu rekaman engine di grid bank: loop PCM 8-bit yang direkam pada
+// refRPM, on-throttle (load=1) atau off-throttle (load=0).
+struct SoundCell {
+  uint8_t *data;
+  uint32_t length;
+  uint32_t loopStart;             // setelah loopEnd-1 lompat ke loopStart
+  uint32_t loopEnd;
+  uint32_t refRPM;
+  uint32_t sampleRate;
+  uint8_t load;
+
+  // State render (hanya disentuh dari konteks render)
+  uint32_t pos;
+  uint32_t frac;
+  int32_t weight;                 // Q15, di-slew per sample ke target
+
+  // Mode granular (header "mode":"granular"): satu grain = satu siklus
+  // pembakaran rekaman, diputar dengan pitch asli
+  bool granular;
+  uint8_t cycleRevs;
+  uint32_t cycleLen;              // 16.16 sample sumber per siklus di refRPM
+  uint32_t cycleOut;              // siklus rekaman dalam sample output
+  uint32_t grainInc;              // 16.16, sampleRate -> AUDIO_OUTPUT_RATE
+  uint32_t mark;                  // posisi sumber grain berikutnya (awal siklus)
+  uint32_t markFrac;              // fraksi 16 bit mark (siklus tidak bulat)
+  int32_t untilOnset;             // 16.16 sample output sampai grain berikutnya
+  GrainVoice grains[2];
+
+  // Ditulis dari task kontrol (32-bit atomik)
+  volatile uint32_t phaseInc;     // 16.16 per sample output
+  volatile uint32_t grainHop;     // 16.16 sample output per siklus di RPM target
+  volatile int32_t targetWeight;  // Q15
+};
+
+// Bank multi-sample RPM x load untuk satu register. Renderer memilih
+// rekaman terdekat di atas/bawah RPM target per layer load, lalu
+// crossfade dengan bobot per-sample, jadi tiap rekaman hanya di-pitch
+// sedikit dari refRPM-nya. Maksimal 2 cell per layer x 2 layer = 4 voice
+// aktif (plus yang sedang fade out).
+//
+// Cell granular tidak di-resample: siklus rekaman diulang pada frekuensi
+// siklus RPM target (TD-PSOLA), jadi formant tetap saat RPM naik.
+class EngineSoundBank {
+public:
+  EngineSoundBank();
+
+  bool addCell(uint8_t *data, uint32_t length, const AudioMeta &meta);
+  void clear();
+  uint8_t getCellCount() { return cellCount; }
+  uint32_t getTotalBytes();
+  uint8_t getActiveVoices();
+  const EnvCurveSet &getEnvelopes() { return envelopes; }
+  const VehicleParams &getVehicle() { return vehicle; }
+  const ShiftSchedule &getShifts() { return shifts; }
+
+  void setRPM(uint32_t rpm);
+  void setLoad(uint8_t load);   // 0 = off-throttle, 255 = full on-throttle
+  uint32_t getRPM() { return targetRPM; }
+  uint32_t rateToRPM(uint32_t rate);
+
+  void IRAM_ATTR render(int16_t *out, size_t count);  // bus mix 16-bit signed
+
+private:
+  void updateTargets();
+  void selectLayer(uint8_t load, uint32_t rpm, int32_t *weights);
+  void IRAM_ATTR renderGranular(SoundCell &cell, size_t len);
+
+  SoundCell cells[AUDIO_BANK_MAX_CELLS];
+  volatile uint8_t cellCount = 0;
+  uint32_t targetRPM = 0;
+  uint8_t targetLoad = 255;
+  EnvCurveSet envelopes;          // kurva rev/shift dari header cell (yang pertama menang)
+  VehicleParams vehicle;          // drivetrain dari cell pertama
+  ShiftSchedule shifts;           // tabel auto shift dari cell pertama
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Parameter satu mesin sintetis. Sudut firing dalam siklus 720 derajat
+// (4-tak), boleh tidak rata (V-twin, big bang).
+struct SynthPreset {
+  const char *name;
+  uint8_t cylinders;
+  uint16_t firing[AUDIO_SYNTH_MAX_CYL];
+  uint16_t idleRPM;
+  uint16_t redlineRPM;
+  uint16_t exhaustHz;      // resonansi knalpot
+  uint8_t damping;         // 1/Q resonator, Q8 (kecil = lebih berdengung)
+  uint8_t noise;           // porsi noise pembakaran 0-255
+};
+
+// Suara engine parametrik tanpa rekaman, dipakai register yang kosong.
+// Tiap silinder memicu pulsa decay eksponensial + noise pada sudut
+// firing-nya, lalu dilewatkan resonator knalpot (state-variable filter
+// fixed point) dan DC blocker. Koefisien dihitung sekali saat preset
+// dipilih; render hanya integer.
+class EngineSynth {
+public:
+  EngineSynth();
+
+  void setPreset(uint8_t index);
+  const SynthPreset &getPreset() { return *preset; }
+  static uint8_t getPresetCount();
+
+  void setRPM(uint32_t rpm);
+  void setLoad(uint8_t load);
+  uint32_t getRPM() { return rpm; }
+  uint32_t rateToRPM(uint32_t rate);
+
+  void IRAM_ATTR render(int16_t *out, size_t count);
+
+private:
+  const SynthPreset *preset;
+
+  // Dihitung saat setPreset (render tidak pernah membaca tabel preset)
+  uint8_t cylinders = 1;
+  uint32_t fireAt[AUDIO_SYNTH_MAX_CYL];   // sudut firing terurut, 2^32 = 720 derajat
+  int32_t cylGain[AUDIO_SYNTH_MAX_CYL];   // variasi amplitudo per silinder (Q15)
+  int32_t svfF = 0;                       // 2*sin(pi*fc/fs), Q15
+  int32_t svfDamp = 256;                  // Q8
+  int32_t noiseMix = 0;                   // Q8
+
+  // Ditulis dari task kontrol (32-bit atomik)
+  volatile uint32_t phaseInc = 0;         // per sample output, 2^32 = satu siklus
+  volatile int32_t loadGain = 32768;      // Q15
+  uint32_t rpm = 0;
+
+  // State render
+  uint32_t phase = 0;
+  uint8_t nextCyl = 0;
+  int32_t env = 0;
+  int32_t low = 0;
+  int32_t band = 0;
+  int32_t dcIn = 0;
+  int32_t dcOut = 0;
+  int32_t level = 0;                      // fade in setelah setPreset (Q15)
+  uint32_t noiseSeed = 0x12345678;
+};
+
+extern EngineSynth engineSynth;
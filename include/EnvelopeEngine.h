@@ -0,0 +1,93 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "FixedMath.h"
+
+// Bentuk segmen kurva, dari level awal segmen ke level keyframe
+// (= kurva easing FixedMath)
+enum EnvShape : uint8_t {
+  ENV_SHAPE_LINEAR = EASE_LINEAR,
+  ENV_SHAPE_SINE = EASE_SINE,      // seperempat sinus: cepat di awal, halus di akhir
+  ENV_SHAPE_SMOOTH = EASE_SMOOTH,  // S-curve (smoothstep)
+  ENV_SHAPE_EXP = EASE_EXP,        // eksponensial: pelan lalu melesat
+};
+
+// Kurva event yang bisa diganti per rekaman (key header "env_*")
+enum EnvCurveId : uint8_t {
+  ENV_REV_UP,          // level 1000 = rev target, tahan di keyframe terakhir
+  ENV_REV_DOWN,
+  ENV_SHIFT_UP,        // level = offset rate permil (300 = +30%)
+  ENV_SHIFT_DOWN,      // blip downshift
+  ENV_CURVE_COUNT
+};
+
+// Kurva di channel yang sama saling menggantikan; antar channel digabung
+enum EnvChannel : uint8_t {
+  ENV_CH_REV,
+  ENV_CH_SHIFT,
+  ENV_CHANNEL_COUNT
+};
+
+struct EnvKey {
+  uint16_t ms;         // durasi segmen menuju keyframe ini
+  int16_t level;       // permil
+  uint8_t shape;       // EnvShape
+};
+
+struct EnvCurve {
+  uint8_t count;
+  EnvKey keys[ENVELOPE_MAX_KEYS];
+};
+
+// Kurva dari metadata aset; bit i mask = curves[i] diisi
+struct EnvCurveSet {
+  uint8_t mask;
+  EnvCurve curves[ENV_CURVE_COUNT];
+};
+
+// Envelope rev/shift dari tabel keyframe, dievaluasi per tick tetap
+// (ENVELOPE_TICK_MS) berapapun jitter pemanggilnya.
+//
+// Trigger menyalin kurva ke voice channel-nya dan mulai dari level
+// channel saat ini, jadi event yang tumpang tindih (rev stop di tengah rev
+// up, shift di tengah shift) menyambung tanpa lompatan. Output:
+// rate = (base + (revTarget - base) * rev) * (1 + shift).
+//
+// trigger() dari task BLE/tombol, update() dari task kontrol: state voice
+// dilindungi mux (critical section pendek, tanpa I/O).
+class EnvelopeEngine {
+public:
+  EnvelopeEngine();
+
+  void setCurves(const EnvCurveSet *set);  // nullptr = kurva bawaan semua
+  void trigger(EnvCurveId id);
+  bool update(uint32_t nowMs);             // true kalau rate perlu diterapkan ulang
+  uint32_t apply(uint32_t baseRate, uint32_t revTarget);
+  bool isBusy(EnvChannel ch);
+  bool isBusy();
+  int32_t getLevel(EnvChannel ch);         // level channel saat ini (permil)
+
+  static bool parseCurve(const char *text, EnvCurve &out);
+  static const char *curveKey(EnvCurveId id);
+
+private:
+  struct Voice {
+    EnvCurve curve;
+    uint8_t seg;       // segmen berjalan (== count: selesai, tahan level)
+    uint16_t segMs;    // waktu di segmen
+    int16_t from;      // level awal segmen
+    int16_t level;
+  };
+
+  void tick();
+  static q16_t shapeAt(uint8_t shape, uint32_t t, uint32_t duration);
+  static bool voiceBusy(const Voice &v) { return v.seg < v.curve.count || v.level != 0; }
+
+  EnvCurve curves[ENV_CURVE_COUNT];
+  Voice voices[ENV_CHANNEL_COUNT];
+  uint32_t lastTick = 0;
+  bool started = false;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern EnvelopeEngine envelopes;
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR   // build host (tools/)
+#endif
+
+// Fixed-point Q16 (1.0 = 65536) untuk ramp/kontrol: deterministik, tanpa
+// float/sinf, aman dipanggil dari ISR atau render blok. Tanpa dependensi
+// Arduino supaya bisa diuji di host (tools/check_fixed_math.cpp).
+typedef int32_t q16_t;
+
+#define Q16_SHIFT        16
+#define Q16_ONE          ((q16_t)1 << Q16_SHIFT)
+
+// Easing 0..1 -> 0..1 dari tabel (EASE_LUT_SIZE titik + interpolasi
+// linear). Tabel dihitung compile-time (constexpr) dari kurva referensi.
+enum EaseCurve : uint8_t {
+  EASE_LINEAR,
+  EASE_SINE,           // seperempat sinus: cepat di awal, halus di akhir
+  EASE_SMOOTH,         // S-curve (smoothstep)
+  EASE_EXP,            // eksponensial (2^10t - 1) / 1023: pelan lalu melesat
+  EASE_COUNT
+};
+
+#define EASE_LUT_BITS    6
+#define EASE_LUT_SIZE    ((1 << EASE_LUT_BITS) + 1)
+#define EASE_FRAC_BITS   (Q16_SHIFT - EASE_LUT_BITS)
+
+struct EaseTable {
+  q16_t v[EASE_LUT_SIZE];
+};
+
+extern const EaseTable EASE_TABLES[EASE_COUNT];
+
+static inline q16_t IRAM_ATTR q16Mul(q16_t a, q16_t b) {
+  return (q16_t)(((int64_t)a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT);
+}
+
+// num/den dalam Q16 (progress ramp), den 0 = selesai
+static inline q16_t IRAM_ATTR q16Ratio(uint32_t num, uint32_t den) {
+  return den ? (q16_t)(((uint64_t)num << Q16_SHIFT) / den) : Q16_ONE;
+}
+
+static inline int32_t IRAM_ATTR q16Lerp(int32_t from, int32_t to, q16_t t) {
+  return from + q16Mul(to - from, t);
+}
+
+static inline q16_t IRAM_ATTR easeQ16(uint8_t curve, q16_t t) {
+  if (t <= 0) return 0;
+  if (t >= Q16_ONE) return Q16_ONE;
+  if (curve >= EASE_COUNT) curve = EASE_LINEAR;
+  const q16_t *lut = EASE_TABLES[curve].v;
+  uint32_t idx = (uint32_t)t >> EASE_FRAC_BITS;
+  int32_t frac = t & ((1 << EASE_FRAC_BITS) - 1);
+  return lut[idx] + (((lut[idx + 1] - lut[idx]) * frac) >> EASE_FRAC_BITS);
+}
+
+// ===== Generator tabel compile-time (C++11 constexpr) =====
+namespace fixedmath {
+
+constexpr double PI_D = 3.14159265358979323846;
+constexpr double LN2_D = 0.69314718055994530942;
+
+// sin 0..pi/2 (Horner Taylor s/d x^15, error < 1e-10)
+constexpr double sinPoly(double x, double x2) {
+  return x * (1 - x2 / 6 * (1 - x2 / 20 * (1 - x2 / 42 * (1 - x2 / 72 *
+         (1 - x2 / 110 * (1 - x2 / 156 * (1 - x2 / 210)))))));
+}
+
+constexpr double expSeries(double x, int n, double term) {
+  return n > 48 ? 0.0 : term + expSeries(x, n + 1, term * x / (n + 1));
+}
+
+// Kurva referensi (juga dipakai host test sebagai pembanding float)
+constexpr double easeRef(uint8_t curve, double t) {
+  return curve == EASE_SINE   ? sinPoly(t * PI_D * 0.5, t * t * PI_D * PI_D * 0.25)
+       : curve == EASE_SMOOTH ? t * t * (3.0 - 2.0 * t)
+       : curve == EASE_EXP    ? (expSeries(10.0 * LN2_D * t, 0, 1.0) - 1.0) / 1023.0
+       : t;
+}
+
+constexpr q16_t easeNode(uint8_t curve, uint32_t i) {
+  return (q16_t)(easeRef(curve, (double)i / (EASE_LUT_SIZE - 1)) * Q16_ONE + 0.5);
+}
+
+template <uint32_t... I> struct Seq {};
+template <uint32_t N, uint32_t... I> struct MakeSeq : MakeSeq<N - 1, N - 1, I...> {};
+template <uint32_t... I> struct MakeSeq<0, I...> { typedef Seq<I...> type; };
+
+template <uint32_t... I>
+constexpr EaseTable makeTable(uint8_t curve, Seq<I...>) {
+  return EaseTable{{easeNode(curve, I)...}};
+}
+
+constexpr EaseTable makeTable(uint8_t curve) {
+  return makeTable(curve, MakeSeq<EASE_LUT_SIZE>::type());
+}
+
+}  // namespace fixedmath
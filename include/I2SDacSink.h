@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include "AudioSink.h"
+#include "config.h"
+
+// Backend I2S ke built-in DAC (GPIO25) lewat DMA. Task output render satu
+// blok AUDIO_BLOCK_SAMPLES lalu i2s_write (blocking sampai ada slot DMA),
+// jadi CPU hanya di-interrupt sekali per buffer DMA, bukan per sample.
+class I2SDacSink : public AudioSink {
+public:
+  bool begin(uint32_t sampleRate, AudioRenderFn render) override;
+  void end() override;
+  void pause() override;
+  void resume() override;
+  uint32_t getSampleRate() const override { return rate; }
+  const char *name() const override { return "i2s-dma"; }
+
+  static void outputTaskWrapper(void *parameter);
+
+private:
+  void outputTask();
+
+  AudioRenderFn renderFn = nullptr;
+  uint32_t rate = 0;
+  volatile bool paused = false;
+  volatile bool running = false;
+
+  uint8_t block[AUDIO_BLOCK_SAMPLES];
+  uint16_t frames[AUDIO_BLOCK_SAMPLES * 2];  // stereo 16-bit, DAC ambil byte atas
+
+  SemaphoreHandle_t renderMutex = nullptr;
+  TaskHandle_t outputTaskHandle = nullptr;
+};
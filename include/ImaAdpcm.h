@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR   // build host (tools/)
+#endif
+
+#define ADPCM_BLOCK_HEADER 4   // int16 predictor (LE) + uint8 step index + reserved
+
+// State encoder/decoder IMA-ADPCM
+struct ImaAdpcmState {
+  int16_t predictor;
+  uint8_t index;
+};
+
+// IMA-ADPCM 4-bit blok untuk aset PCM 8-bit. Tiap blok mandiri: header
+// berisi predictor + step index awal, lalu 2 sample per byte (nibble bawah
+// dulu), jadi decode bisa mulai di awal blok mana saja (loop, seek).
+// Decoder table-driven tanpa pembagian/float, aman dipanggil dari render.
+// Tanpa dependensi Arduino supaya bisa di-encode/benchmark di host.
+class ImaAdpcm {
+public:
+  static uint32_t samplesPerBlock(uint32_t blockBytes) {
+    return (blockBytes - ADPCM_BLOCK_HEADER) * 2;
+  }
+
+  // Decode satu blok penuh ke PCM 8-bit unsigned, return jumlah sample
+  static uint32_t IRAM_ATTR decodeBlock(const uint8_t *block, uint32_t blockBytes, uint8_t *out);
+
+  // Encode `count` sample PCM 8-bit ke satu blok (sisa blok diisi padding).
+  // `state.index` dibawa antar blok supaya step tidak mulai dari nol lagi.
+  static void encodeBlock(const uint8_t *pcm, uint32_t count, uint8_t *block,
+                          uint32_t blockBytes, ImaAdpcmState &state);
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Sumber input yang diukur latency-nya
+enum LatencySource : uint8_t {
+  LAT_ADC,      // throttle bergerak (ADC task)
+  LAT_BUTTON,   // tombol A/B ditekan
+  LAT_BLE,      // command BLE diterima callback NimBLE
+  LAT_CAN,      // frame OBD2 diterima
+  LAT_SOURCE_COUNT
+};
+
+struct LatencyStats {
+  uint32_t count;
+  uint32_t p50Us;
+  uint32_t p99Us;
+  uint32_t maxUs;
+};
+
+// Latency input -> suara, per sumber. Alur satu event:
+//   stamp()   saat input tiba (task/callback mana saja)
+//   applied() saat jalur kontrol mengubah parameter audio (rate, load,
+//             bank, efek, volume) karena event itu; cancel() kalau event
+//             tidak mengubah suara
+//   onRender() di awal render blok: event yang sudah applied ditutup,
+//             latency = sekarang - stamp + antrian blok output ke DAC
+// Event beruntun sebelum suara berubah digabung (dihitung dari yang
+// pertama), jadi slope limiter ADC dan command BLE yang menunggu ikut
+// terukur. Event yang tidak pernah applied/cancel (jalur yang lupa
+// menutup) kedaluwarsa setelah LATENCY_STALE_MS: tidak direkam dan tidak
+// menelan event berikutnya. Timestamp pakai micros() (esp_timer), bukan CCOUNT: CCOUNT
+// per core dan input/render jalan di core berbeda.
+// Histogram log-linear (8 bucket per oktaf, resolusi ~12%), update hanya
+// dari render task; pembacaan dari task lain boleh sedikit tidak konsisten.
+class LatencyProbe {
+public:
+  LatencyProbe();
+
+  void stamp(LatencySource src);
+  void applied(LatencySource src);
+  void cancel(LatencySource src);
+  void IRAM_ATTR onRender();
+
+  bool getStats(LatencySource src, LatencyStats &stats);
+  String report();
+  void printReport();
+  void reset();
+
+  static const char *sourceName(LatencySource src);
+
+private:
+  enum EventState : uint8_t { EVENT_IDLE, EVENT_ARRIVED, EVENT_APPLIED };
+
+  struct SourceState {
+    volatile uint32_t arrivedUs;
+    volatile uint8_t state;
+    uint32_t maxUs;
+    uint32_t count;
+    uint32_t buckets[LATENCY_BUCKETS];
+  };
+
+  SourceState sources[LAT_SOURCE_COUNT];
+
+  void IRAM_ATTR record(SourceState &s, uint32_t us);
+  static uint8_t IRAM_ATTR bucketOf(uint32_t us);
+  static uint32_t bucketUpper(uint8_t idx);
+};
+
+extern LatencyProbe latencyProbe;
@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOOP_MATCH_WINDOW    32    // sample dibandingkan di kiri/kanan titik loop
+#define LOOP_MAX_CANDIDATES  48    // zero crossing per sisi yang dicoba
+#define LOOP_SEARCH_SPAN     4096  // awal/akhir file yang dicari (max)
+
+// Titik loop dalam sample relatif ke awal data audio. Playback jalan dari
+// 0, lalu setelah sample end-1 lompat ke start.
+struct LoopPoints {
+  uint32_t start;
+  uint32_t end;
+};
+
+// Cari titik loop engine yang seamless: kandidat start = zero crossing naik
+// di awal rekaman, kandidat end = zero crossing naik di akhir rekaman.
+// Tiap pasangan dinilai dari selisih bentuk gelombang + slope di sekitar
+// kedua titik (SAD, early exit), pasangan termurah dipakai. Tanpa
+// dependensi Arduino supaya bisa dites di host.
+class LoopAnalyzer {
+public:
+  // Data lengkap di RAM
+  static bool find(const uint8_t *data, uint32_t length, LoopPoints &loop);
+
+  // Hanya potongan awal (head = data[0..headLen)) dan akhir
+  // (tail = data[tailOffset..tailOffset+tailLen)), untuk file yang di-stream
+  static bool findInSegments(const uint8_t *head, uint32_t headLen,
+                             const uint8_t *tail, uint32_t tailLen,
+                             uint32_t tailOffset, LoopPoints &loop);
+
+  // Panjang potongan awal/akhir yang dianalisis untuk data sepanjang `length`
+  static uint32_t searchSpan(uint32_t length);
+
+  // Crossfade tail: `fadeLen` sample terakhir sebelum end di-blend ke sample
+  // sebelum start, jadi lompatan loop kontinu. Hanya di RAM (file tetap asli).
+  static void applyCrossfadeTail(uint8_t *data, const LoopPoints &loop, uint32_t fadeLen);
+};
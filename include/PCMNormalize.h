@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Kernel normalisasi PCM 8-bit, tanpa dependensi Arduino supaya bisa
+// di-benchmark di host (tools/bench_normalize.cpp).
+//
+// Mapping normalisasi hanya bergantung pada nilai byte input, jadi cukup
+// 256 operasi float untuk membangun tabel remap; sisanya satu lookup per
+// sample. Hasilnya bit-exact dengan versi float per-sample.
+class PCMNormalize {
+public:
+  // Min/max word-at-a-time (SWAR, 4 byte per operasi 32-bit). Nilai awal
+  // minValue/maxValue ikut dihitung supaya bisa dipanggil per chunk.
+  static void findRange(const uint8_t *data, size_t length, uint8_t &minValue, uint8_t &maxValue);
+
+  // Tabel remap ke range 19-237 centered di 127
+  static void buildLUT(uint8_t minValue, uint8_t maxValue, uint8_t lut[256]);
+  static void applyLUT(uint8_t *data, size_t length, const uint8_t lut[256]);
+
+  static void normalize(uint8_t *data, size_t length);
+
+  // Versi lama (2 pass, float per sample) - referensi untuk benchmark/test
+  static void normalizeReference(uint8_t *data, size_t length);
+};
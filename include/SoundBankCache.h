@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "EngineSoundBank.h"
+
+class AudioSink;
+
+struct SoundCacheEntry {
+  String folder;               // "" = slot kosong
+  EngineSoundBank bank;
+  uint32_t lastUsed;           // counter LRU
+  bool stale;                  // file register berubah, reload saat dipakai lagi
+  bool filling;                // sedang diisi di luar lock: tidak di-evict/find
+};
+
+// Cache sound bank per register. Rekaman semua register disimpan decoded
+// di RAM (atau PSRAM kalau ada) selama total ukurannya muat budget, jadi
+// pindah register cukup ganti pointer bank aktif tanpa baca LittleFS.
+// Kalau budget/heap habis, slot yang paling lama tidak dipakai di-evict.
+//
+// Cache juga pemilik pointer bank aktif yang dibaca render: bank hanya
+// di-free setelah sink di-pause, jadi render tidak pernah membaca buffer
+// yang sudah di-free.
+//
+// Mutex hanya dipegang selama operasi slot (find/acquire/activate/drop),
+// bukan selama baca LittleFS: slot hasil acquire ditandai filling sampai
+// commit/drop, jadi tidak di-evict atau dipakai task lain selama diisi.
+class SoundBankCache {
+public:
+  SoundBankCache();
+
+  void begin(AudioSink *outputSink);
+  void lock();
+  void unlock();
+
+  EngineSoundBank *find(const char *folder);
+  EngineSoundBank *acquire(const char *folder);
+  void commit(EngineSoundBank *bank);
+  void drop(EngineSoundBank *bank);
+  uint8_t *allocate(uint32_t length, EngineSoundBank *filling);
+  bool fits(uint32_t length);
+
+  void activate(EngineSoundBank *bank);
+  inline EngineSoundBank *IRAM_ATTR active() const { return activeBank; }
+  inline EngineSoundBank *IRAM_ATTR retired() const { return retiredBank; }
+
+  void dropStale(const char *folder);
+  void invalidate(const char *path);
+  void invalidateAll();
+
+  uint32_t getUsedBytes();
+  uint32_t getBudget() { return budget; }
+  void printStatus();
+
+private:
+  SoundCacheEntry *entryFor(EngineSoundBank *bank);
+  bool inUse(const SoundCacheEntry &entry) const;
+  uint8_t evictRank(SoundCacheEntry &entry);
+  SoundCacheEntry *lruVictim(EngineSoundBank *keep);
+  bool evictLRU(EngineSoundBank *keep);
+  void release(SoundCacheEntry &entry);
+
+  SoundCacheEntry entries[AUDIO_CACHE_SLOTS];
+  EngineSoundBank *volatile activeBank = nullptr;
+  EngineSoundBank *volatile retiredBank = nullptr;  // bank aktif sebelumnya (sumber crossfade swap)
+  AudioSink *sink = nullptr;
+  SemaphoreHandle_t mutex = nullptr;
+  uint32_t useCounter = 0;
+  uint32_t budget = AUDIO_CACHE_BUDGET_RAM;
+  bool usePSRAM = false;
+};
+
+extern SoundBankCache soundCache;
@@ -4,6 +4,10 @@
 #include "ButtonManager.h"
 #include "LEDManager.h"
 #include "BLEControl.h"
+#include "AudioLoader.h"
+#include "EnvelopeEngine.h"
+#include "VehicleModel.h"
+#include "AutoShift.h"
 
 enum SystemMode {
   MODE_NORMAL,
@@ -14,37 +18,28 @@ class SystemManager {
 public:
   SystemManager();
   void begin(AudioPlayer* audioPlayer = nullptr);
-  void update();
   void updateButtons();
   void updateBLE();
   void updateLEDs();
   void setCurrentThrottleRate(uint32_t rate) { currentThrottleRate = rate; }
-  bool isRevActive() { return isRevving || isRevDown; }
-  bool isShiftActive() { return isShifting; }
+  void setThrottlePosition(uint16_t raw) { vehicle.setThrottle(raw); }
+  bool isRevActive() { return envelopes.isBusy(ENV_CH_REV); }
+  bool isShiftActive() { return envelopes.isBusy(ENV_CH_SHIFT); }
   
 private:
+  static SystemManager* instance;
+  static void onSoundLoaded(const AudioLoadStatus &status);
+  
   AudioPlayer* player;
   
-  // Simple rev variables
-  bool isRevving = false;
-  bool isRevDown = false;
-  unsigned long revStartTime = 0;
-  unsigned long revDownStartTime = 0;
-  uint32_t prevNormalRate = 8000;
+  // Rev/shift: kurva di EnvelopeEngine. Dengan VehicleModel, level rev =
+  // override gas dan pitch dari RPM model; tanpa model, base = rate
+  // throttle saat ini. Gigi disimpan di VehicleModel (0 = netral).
+  bool isRevving = false;               // tombol/command rev masih ditahan
+  bool envelopeWasBusy = false;
   uint32_t currentThrottleRate = 8000;  // Track current throttle
-  const uint32_t revTargetRate = 39000;  // Match original
-  const unsigned long revRampDuration = 300;  // Match original
-  const unsigned long revDownDuration = 400;
-  
-  // Simple shift variables
-  bool isShifting = false;
-  unsigned long shiftStartTime = 0;
-  uint32_t shiftBaseRate = 8000;
-  uint32_t shiftTargetRate = 8000;
-  uint8_t shiftPhase = 0;  // 0=drop, 1=recovery
+  const uint32_t revTargetRate = 39000;  // level rev 1000 = rate ini
   
-  uint8_t currentGear = 0;
-  const uint8_t maxGear = 4;
   ButtonManager buttons;
   LEDManager leds; 
   BLEControl ble;
@@ -52,6 +47,10 @@ private:
   SystemMode currentMode = MODE_NORMAL;
   uint8_t currentRegister = 1;
   bool isPlaying = false;
+  volatile bool crankPending = false;  // putar efek start saat register selesai di-load
+  volatile bool loadDone = false;      // set loader task, diproses di updateButtons
+  bool stopPending = false;            // tunggu efek stop selesai sebelum mute
+  unsigned long lastDiagReport = 0;
   
   void handleNormalMode();
   void handleProgrammingMode();
@@ -61,15 +60,17 @@ private:
   void enterProgrammingMode();
   void exitProgrammingMode();
   void loadCurrentSound();
+  void startLoadedSound();
+  void preloadSounds();
   void formatLittleFS();
   void deleteCurrentRegisterFile();
   void deleteAllFiles();
   void startRev();
   void stopRev();
-  void updateRev();
-  void triggerShift();
   void triggerGearUp();
   void triggerGearDown();
-  void updateShift();
+  void shiftTo(uint8_t gear, bool automatic);
+  void toggleAutoShift();
+  void updateDrive();
 
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_adc_cal.h>
+#include "config.h"
+
+// Akuisisi throttle kontinu di task sendiri:
+//   ADC continuous (DMA) THROTTLE_ADC_RATE -> rata-rata THROTTLE_OVERSAMPLE
+//   konversi (decimation, resolusi Q4) -> linearisasi kurva kalibrasi eFuse
+//   (mV) -> skala 0-4095 antara THROTTLE_MV_MIN..MAX -> filter one-euro
+//   (cutoff naik sebanding kecepatan gerak: halus saat diam, hentakan gas
+//   langsung lolos).
+//
+// Hasil dipublish lock-free sebagai satu word 32-bit (terfilter | raw << 16),
+// jadi pembaca di task/core manapun selalu dapat pasangan yang konsisten
+// tanpa mux, di rate berapapun.
+class ThrottleInput {
+public:
+  bool begin();
+
+  uint32_t read() { return published; }                  // snapshot
+  static uint16_t filtered(uint32_t snap) { return snap & 0xFFFF; }
+  static uint16_t raw(uint32_t snap) { return snap >> 16; }  // decimated, belum difilter
+
+  uint16_t get() { return filtered(published); }
+  uint32_t getSampleRate() { return outputRate; }
+  bool isDma() { return dma; }
+
+private:
+  static void taskEntry(void *param);
+  bool startDma(int8_t channel);
+  void runDma(int8_t channel);
+  void runPolled();
+  uint16_t linearize(uint32_t sum, uint32_t count);
+  void push(uint16_t value);
+
+  esp_adc_cal_characteristics_t cal;
+  bool dma = false;
+  uint32_t outputRate = 1000;
+
+  // State one-euro (hanya task throttle)
+  bool primed = false;
+  float value = 0.0f;
+  float prevInput = 0.0f;
+  float slope = 0.0f;          // turunan terfilter (count/detik)
+  float slopeAlpha = 1.0f;
+
+  volatile uint32_t published = 0;
+};
+
+extern ThrottleInput throttleInput;
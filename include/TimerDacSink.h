@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+#include "AudioSink.h"
+#include "config.h"
+
+// Backend timer: ISR hanya pop satu sample per tick dari double buffer
+// lalu dacWrite. Semua proses audio (resample, mix, volume) jalan di
+// render task (pinned ke AUDIO_TASK_CORE) yang mengisi blok
+// AUDIO_BLOCK_SAMPLES.
+//
+// Handoff lock-free: blockReady[i] dimiliki render task saat false dan
+// dimiliki ISR saat true. ISR membalik flag setelah blok habis lalu
+// notify render task.
+class TimerDacSink : public AudioSink {
+public:
+  bool begin(uint32_t sampleRate, AudioRenderFn render) override;
+  void end() override;
+  void pause() override;
+  void resume() override;
+  uint32_t getSampleRate() const override { return rate; }
+  uint32_t getUnderruns() const override { return underruns; }
+  const char *name() const override { return "timer"; }
+
+  static void IRAM_ATTR onTimerISR();
+  static void renderTaskWrapper(void *parameter);
+
+private:
+  void renderTask();
+
+  static hw_timer_t *timer;
+  static uint8_t blocks[2][AUDIO_BLOCK_SAMPLES];
+  static volatile bool blockReady[2];
+  static volatile uint8_t playingBlock;
+  static uint16_t readPos;
+  static uint8_t lastSample;
+  static volatile uint32_t underruns;
+  static TaskHandle_t renderTaskHandle;
+
+  AudioRenderFn renderFn = nullptr;
+  uint32_t rate = 0;
+  volatile bool paused = false;
+  volatile bool running = false;
+  SemaphoreHandle_t renderMutex = nullptr;
+};
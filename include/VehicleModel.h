@@ -0,0 +1,104 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "FixedMath.h"
+
+// Parameter drivetrain per aset. 0 di field opsional = nilai bawaan
+// (dihitung dari rentang RPM saat setParams).
+struct VehicleParams {
+  uint16_t idleRPM;          // playable_min
+  uint16_t topRPM;           // playable_max: RPM ini = pitch tertinggi
+  uint16_t limitRPM;         // maxRPM: rev limiter (potong bahan bakar)
+  uint8_t gearCount;
+  float ratios[VEHICLE_MAX_GEARS];  // rasio total relatif gigi teratas ("gear_ratios")
+  float revRate;             // RPM/detik free-rev gas penuh ("rev_rate")
+  float engineBrake;         // RPM/detik engine brake di limiter, gas tutup ("engine_brake")
+  float inertia;             // inersia kendaraan di gigi teratas, engine = 1 ("inertia")
+  uint16_t shiftMs;          // kopling terbuka saat pindah gigi ("shift_ms")
+  uint16_t clutchMs;         // kopling menyambung kembali ("clutch_ms")
+};
+
+// Model engine + drivetrain fixed-step (VEHICLE_STEP_US, ~1 kHz), satuan
+// RPM dengan inersia engine = 1 (torsi dalam RPM/detik):
+//   engine  : gas -> torsi (kurva torsi), rugi pompa/engine brake, idle
+//             governor, rev limiter dengan histeresis
+//   kopling : torsi sebanding slip, dibatasi kapasitas (sentrifugal saat
+//             start, dibuka/disambung saat pindah gigi -> RPM turun/naik
+//             lewat slip, bukan lompat)
+//   kendaraan: inersia dipantulkan lewat rasio gigi, hambatan rolling + aero
+// Gigi 0 = netral (free rev). Output RPM dipetakan ke rate pitch
+// (idle..topRPM -> 8-44.1kHz, sama dengan rentang potensio lama).
+//
+// Throttle/shift/params ditulis task lain (32-bit atomik / mux), update()
+// hanya dari task kontrol.
+class VehicleModel {
+public:
+  VehicleModel();
+
+  void setParams(const VehicleParams &params);
+  static void defaultParams(VehicleParams &params);
+  static bool parseRatios(const char *text, VehicleParams &out);  // "gear_ratios"
+
+  void setThrottle(uint16_t raw);            // ADC 0-4095
+  void setThrottleOverride(int32_t permil);  // rev envelope, 0 = tidak ada
+  void shift(uint8_t gear);
+  bool update(uint32_t nowUs);               // true kalau RPM/load berubah
+
+  uint8_t getGear() { return requestedGear; }
+  uint8_t getGearCount() { return gearCount; }
+  uint32_t getRPM() { return publishedRPM; }
+  uint8_t getLoad() { return publishedLoad; }
+  bool isShifting() { return shiftPhase != SHIFT_IDLE; }
+  bool isLimiting() { return limiterCut; }
+
+  // Untuk AutoShift (task kontrol yang sama dengan update())
+  uint16_t getThrottle();                    // max(pedal, override) 0-4095
+  uint16_t getIdleRPM() { return p.idleRPM; }
+  uint16_t getLimitRPM() { return p.limitRPM; }
+  uint16_t getRatioPermil(uint8_t gear);     // rasio gigi x 1000 (gigi teratas = 1000)
+  uint32_t getParamsVersion() { return paramsVersion; }
+
+private:
+  enum ShiftPhase : uint8_t { SHIFT_IDLE, SHIFT_OPEN, SHIFT_ENGAGE };
+
+  void applyParams();
+  void step();
+  float torqueShape(float x);
+
+  // Parameter aktif (hanya task kontrol)
+  VehicleParams p;
+  VehicleParams pending;
+  volatile bool paramsPending = false;
+  float range = 1.0f;        // topRPM - idleRPM
+  float clutchK = 0.0f;      // kekakuan kopling (1/detik), stabil untuk step tetap
+  float clutchCap = 0.0f;
+  uint16_t ratioPermil[VEHICLE_MAX_GEARS];
+  uint32_t paramsVersion = 0;  // naik tiap parameter baru diterapkan
+
+  // State fisika
+  float rpm = 0.0f;
+  float driveRPM = 0.0f;     // kecepatan roda dalam RPM engine di gigi teratas
+  uint8_t gear = 0;
+  bool limiterCut = false;
+  volatile uint8_t shiftPhase = SHIFT_IDLE;
+  bool upshift = false;
+  uint32_t shiftLeft = 0;    // step tersisa di fase shift
+  q16_t clutch = Q16_ONE;    // kapasitas kopling dari sequencer shift (S-curve)
+  float throttleEff = 0.0f;
+
+  // Input (ditulis task lain)
+  volatile uint16_t throttleRaw = 0;
+  volatile int32_t overridePermil = 0;
+  volatile uint8_t requestedGear = 0;
+  volatile uint8_t gearCount = 4;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  uint32_t lastStep = 0;
+  bool started = false;
+
+  // Output
+  volatile uint32_t publishedRPM = 0;
+  volatile uint8_t publishedLoad = 0;
+};
+
+extern VehicleModel vehicle;
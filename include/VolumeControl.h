@@ -1,26 +1,64 @@
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 
+#define VOLUME_UNITY     32768                 // gain Q15 = 1.0
+
+// Target volume yang dipublikasikan ke render sekaligus (gain + durasi
+// ramp), jadi render tidak pernah melihat gain baru dengan ramp lama
+struct VolumeState {
+  int32_t targetGain;      // Q15, 0 saat mute
+  uint32_t rampSamples;    // durasi interpolasi ke target
+};
+
+// Tahap akhir jalur audio: gain volume di bus mix 16-bit (signed, 0 =
+// tengah DAC), limiter soft-knee, lalu kuantisasi ke kode DAC 8-bit dengan
+// noise shaping error-feedback orde 1, jadi volume kecil tetap punya
+// resolusi.
+//
+// Task kontrol menulis VolumeState di bawah seqlock (nomor urut ganjil
+// selama ditulis); render menyalin state sekali per blok saat nomor urut
+// berubah, jadi beberapa publish di antara dua blok tidak pernah hilang.
+// Perubahan gain di-ramp per sample (VOLUME_RAMP_MS), mute/unmute fade
+// (VOLUME_FADE_MS).
 class VolumeControl {
 public:
   VolumeControl();
-  
+
   void begin();
   void setVolume(uint8_t level);  // 0-100
   void mute(bool enable);
   void toggleMute();
-  
-  uint8_t processAudioSample(uint8_t sample);
+
+  // Satu blok bus 16-bit -> kode DAC 8-bit (dipanggil dari render)
+  void IRAM_ATTR processBlock(const int16_t *in, uint8_t *out, size_t count);
   bool isMuted() { return muted; }
   uint8_t getVolume() { return currentVolume; }
-  
+  uint32_t getLimitedSamples() { return limitedSamples; }
+
 private:
-  void buildVolumeLUT();
-  
-  uint8_t volumeLUT[256];
+  void publish(uint32_t rampMs);
+  int32_t IRAM_ATTR limiterGain(int32_t env);
+
   uint8_t currentVolume = 50;  // Default 50%
   bool muted = false;
-  float volumeMultiplier = 0.5f;
+
+  // Seqlock state (ditulis task kontrol di bawah stateMux)
+  VolumeState state;
+  volatile uint32_t stateSeq = 0;
+  portMUX_TYPE stateMux = portMUX_INITIALIZER_UNLOCKED;
+
+  // State render (hanya disentuh dari konteks render)
+  uint32_t seenSeq = 0;
+  int32_t curGain = 0;         // Q15, mulai dari diam (fade in saat boot)
+  int32_t targetGain = 0;
+  int32_t rampStep = 0;
+  uint32_t rampLeft = 0;
+  int32_t limitEnv = 0;        // envelope puncak setelah gain
+  int32_t limitGain = VOLUME_UNITY;
+  int32_t shapeErr = 0;        // error kuantisasi sample sebelumnya
+  uint32_t ditherSeed = 1;
+  volatile uint32_t limitedSamples = 0;  // sample yang dilewatkan dengan gain limiter < 1
 };
 
-extern VolumeControl volumeControl;
\ No newline at end of file
+extern VolumeControl volumeControl;
@@ -16,10 +16,150 @@
 
 // Playback buffer
 #define AUDIO_RING_CAPACITY   (32*1024) // 32KB ring buffer - adjust memory vs performance
+#define AUDIO_STREAM_CHUNK    4096      // ukuran baca reader task (1 blok LittleFS)
+#define AUDIO_STREAM_THRESHOLD (64*1024) // file lebih besar dari ini di-stream, bukan di-load ke RAM
 
-// Header JSON max size
-#define AUDIO_HEADER_MAXLEN   512
+// Header JSON max size (semua key terdokumentasi: env_*, gear_ratios,
+// shift_up/shift_down 6 gigi, normalized/loop_* muat)
+#define AUDIO_HEADER_MAXLEN   1024
+
+// Aset IMA-ADPCM ("format":"adpcm")
+#define AUDIO_ADPCM_MAX_BLOCK 1024     // blok terbesar (power of 2, >= 64)
+#define AUDIO_ADPCM_FIFO      4096     // sample PCM hasil decode stream (power of 2)
 
 // Timer for ISR (uses timer0)
 #define TIMER_GROUP           0
 #define TIMER_INDEX           0
+
+// Output DAC jalan di rate tetap, pitch diatur lewat phase increment 16.16
+#define AUDIO_OUTPUT_RATE     40000  // Hz, harus membagi 1MHz (timer tick 1us)
+#define AUDIO_PHASE_BITS      16     // bit fraksi phase accumulator
+
+// Backend output: timer ISR + dacWrite per sample, atau I2S built-in DAC + DMA
+#define AUDIO_BACKEND_TIMER   0
+#define AUDIO_BACKEND_I2S     1
+#ifndef AUDIO_OUTPUT_BACKEND
+#define AUDIO_OUTPUT_BACKEND  AUDIO_BACKEND_TIMER  // override via build_flags
+#endif
+
+#define AUDIO_BLOCK_SAMPLES   256    // sample per blok render (128-512) / buffer DMA
+#define AUDIO_DMA_BUF_COUNT   4      // jumlah buffer DMA I2S
+#define AUDIO_TASK_PRIORITY   5      // render task audio, di atas BLE/ADC
+#define AUDIO_TASK_CORE       1
+
+// Sound bank multi-sample (grid RPM x load per register)
+#define AUDIO_BANK_MAX_CELLS  8      // rekaman .raw per folder register
+#define AUDIO_BANK_FADE_SAMPLES 256  // durasi crossfade antar cell (~6ms)
+#define AUDIO_BANK_MAX_STEP   (4UL << AUDIO_PHASE_BITS)  // batas pitch-up per cell
+#define AUDIO_LOOP_XFADE_SAMPLES 64  // crossfade tail di titik loop (0 = off)
+
+// Mode granular: satu grain = satu siklus pembakaran rekaman, di-overlap-add
+// pada frekuensi siklus RPM target (timbre tidak ikut di-pitch)
+#define AUDIO_GRAIN_WINDOW    256    // entry tabel jendela Hann Q15 (power of 2)
+#define AUDIO_GRANULAR_DEFAULT 0     // 1 = rekaman tanpa "mode" di header jadi granular
+
+// Cache register: bank tiap register tetap di RAM/PSRAM selama muat budget
+#define AUDIO_CACHE_SLOTS     4              // satu slot per register
+#define AUDIO_CACHE_BUDGET_RAM   (128*1024)  // tanpa PSRAM, sisakan heap untuk BLE
+#define AUDIO_CACHE_BUDGET_PSRAM (3*1024*1024)
+
+// Loader register di background (request queue, swap dengan crossfade)
+#define AUDIO_LOADER_QUEUE    8
+#define AUDIO_LOADER_PRIORITY 1      // sama dengan ADC task, di bawah BLE
+#define AUDIO_LOADER_CORE     0
+#define AUDIO_LOADER_PATH_MAX 32
+#define AUDIO_SWAP_FADE_SAMPLES 256  // crossfade bank lama -> baru (~6ms)
+#define AUDIO_SWAP_RELEASE_MS   20   // > fade + 2 blok: bank lama reload baru di-free
+
+// Upload BLE: file yang menunggu normalisasi di BLE task
+#define BLE_NORMALIZE_QUEUE    4
+#define BLE_NORMALIZE_PATH_MAX 64
+
+// Rantai DSP engine per blok (fixed point): DC high-pass, low-pass ikut
+// throttle, comb resonansi knalpot ikut RPM. Koefisien dari tabel.
+#define AUDIO_DSP_ENABLED      1
+#define AUDIO_DSP_MAX_STAGES   4
+#define AUDIO_DSP_HP_HZ        25     // buang DC sisa normalisasi
+#define AUDIO_DSP_LP_MIN_HZ    1500   // cutoff low-pass throttle tertutup
+#define AUDIO_DSP_LP_MAX_HZ    14000  // cutoff low-pass full throttle
+#define AUDIO_DSP_LP_STEPS     32     // entry tabel low-pass (load 0-255)
+#define AUDIO_DSP_COMB_MAX     1024   // delay line comb (sample, power of 2)
+#define AUDIO_DSP_COMB_STEPS   64     // entry tabel delay comb (RPM)
+#define AUDIO_DSP_COMB_MAX_RPM 16000
+#define AUDIO_DSP_COMB_CYL     4      // silinder untuk frekuensi firing comb
+
+// Engine synth untuk register kosong (tanpa rekaman)
+#define AUDIO_SYNTH_MAX_CYL      8
+
+// Efek one-shot (shift, pop, start/stop) di-mix di atas loop engine
+#define AUDIO_EFFECT_VOICES      6             // voice polifonik, yang tertua dicuri
+#define AUDIO_EFFECT_MAX_SAMPLES 16            // rekaman efek di pool (semua jenis)
+#define AUDIO_EFFECT_POOL_RAM    (32*1024)     // pool sample, dialokasi sekali saat boot
+#define AUDIO_EFFECT_POOL_PSRAM  (256*1024)
+#define AUDIO_EFFECT_QUEUE       8             // trigger yang menunggu render
+
+// Volume: ramp gain, fade mute, limiter soft-knee sebelum DAC
+#define VOLUME_RAMP_MS             5       // interpolasi perubahan volume
+#define VOLUME_FADE_MS             20      // fade mute/unmute dan start/stop
+#define VOLUME_LIMIT_THRESHOLD     24576   // awal knee (0.75 full scale bus 16-bit)
+#define VOLUME_LIMIT_CEILING       32000   // puncak maksimum setelah limiter
+#define VOLUME_LIMIT_BLOCK         32      // sub-blok deteksi puncak (0.8ms)
+#define VOLUME_LIMIT_RELEASE_SHIFT 6       // release ~64 sub-blok (~50ms)
+
+// Throttle (ThrottleInput): ADC continuous/DMA, oversampling + decimation,
+// linearisasi kalibrasi eFuse, filter adaptif one-euro. Backend I2S
+// memakai I2S0 (sama dengan DMA ADC ESP32) -> fallback polling analogRead.
+#define THROTTLE_ADC_RATE        20000         // konversi/detik (minimum DMA ADC ESP32)
+#define THROTTLE_DMA_FRAME       64            // konversi per frame DMA (3.2ms)
+#define THROTTLE_OVERSAMPLE      16            // konversi per sample output (1250 Hz)
+#define THROTTLE_POLL_OVERSAMPLE 4             // fallback: analogRead per ms (1000 Hz)
+#define THROTTLE_MV_MIN          150           // tegangan = throttle 0 (deadband bawah)
+#define THROTTLE_MV_MAX          3100          // tegangan = throttle penuh (deadband atas)
+#define THROTTLE_MIN_CUTOFF_HZ   1.0f          // one-euro: cutoff saat diam
+#define THROTTLE_BETA            0.004f        // cutoff tambahan per count/detik gerakan
+#define THROTTLE_DCUTOFF_HZ      20.0f         // low-pass turunan (deteksi gerakan)
+#define THROTTLE_TASK_PRIORITY   3             // di atas ADC task, di bawah render audio
+#define THROTTLE_TASK_CORE       0
+#define THROTTLE_LOG_MS          200           // jeda minimal log "ADC:" di serial (0 = off)
+
+// Envelope rev/shift: kurva keyframe (bawaan atau "env_*" di header aset)
+#define ENVELOPE_TICK_MS         5             // control rate tetap (200 Hz)
+#define ENVELOPE_MAX_KEYS        4             // keyframe per kurva
+#define ENVELOPE_MAX_CATCHUP     20            // tick maksimal yang dikejar per update
+
+// Model engine + drivetrain (VehicleModel): RPM dari fisika, bukan
+// langsung dari potensio. 0 = throttle -> pitch langsung + envelope (lama)
+#define VEHICLE_MODEL_ENABLED    1
+#define VEHICLE_STEP_US          1000          // step integrasi tetap (1 kHz)
+#define VEHICLE_MAX_GEARS        6
+#define VEHICLE_MAX_CATCHUP      50            // step maksimal yang dikejar per update
+
+// Auto shift (AutoShift): tabel RPM per gigi x posisi throttle ("shift_up",
+// "shift_down" di header aset), hanya dengan VEHICLE_MODEL_ENABLED
+#define AUTOSHIFT_TICK_MS        20            // control rate evaluasi (50 Hz)
+#define AUTOSHIFT_THROTTLE_BINS  4             // kolom tabel: 0%, 33%, 67%, 100%
+#define AUTOSHIFT_MIN_DWELL_MS   800           // jeda minimal antar shift otomatis
+#define AUTOSHIFT_HYST_RPM       300           // jarak minimal RPM setelah upshift ke titik downshift
+#define AUTOSHIFT_KICKDOWN_MS    300           // jendela deteksi lonjakan throttle
+#define AUTOSHIFT_KICKDOWN_DELTA 1500          // kenaikan ADC dalam jendela = kickdown
+#define AUTOSHIFT_KICKDOWN_MIN   3300          // throttle minimal (ADC) untuk kickdown
+
+// Diagnostik: latency input -> suara (LatencyProbe), profiler ISR/render
+// (AudioProfiler). Laporan berkala ke serial + characteristic BLE diag.
+#define DIAG_REPORT_MS           10000         // laporan berkala ke serial (0 = off)
+#ifndef AUDIO_PROFILER
+#define AUDIO_PROFILER           1             // 0 = profiler dihapus total, override via build_flags
+#endif
+#define LATENCY_BUCKETS          192           // histogram log-linear, 8 per oktaf (~67 detik)
+#define LATENCY_ADC_DELTA        40            // perubahan raw ADC yang dihitung satu event
+#define LATENCY_STALE_MS         5000          // event lebih tua dari ini dibuang, tidak diukur
+
+static_assert((AUDIO_RING_CAPACITY & (AUDIO_RING_CAPACITY - 1)) == 0, "AUDIO_RING_CAPACITY harus power of 2");
+static_assert((AUDIO_SWAP_FADE_SAMPLES & (AUDIO_SWAP_FADE_SAMPLES - 1)) == 0, "AUDIO_SWAP_FADE_SAMPLES harus power of 2");
+static_assert((AUDIO_GRAIN_WINDOW & (AUDIO_GRAIN_WINDOW - 1)) == 0, "AUDIO_GRAIN_WINDOW harus power of 2");
+static_assert((AUDIO_DSP_COMB_MAX & (AUDIO_DSP_COMB_MAX - 1)) == 0, "AUDIO_DSP_COMB_MAX harus power of 2");
+static_assert((AUDIO_EFFECT_QUEUE & (AUDIO_EFFECT_QUEUE - 1)) == 0, "AUDIO_EFFECT_QUEUE harus power of 2");
+static_assert((AUDIO_ADPCM_FIFO & (AUDIO_ADPCM_FIFO - 1)) == 0, "AUDIO_ADPCM_FIFO harus power of 2");
+static_assert(AUDIO_STREAM_CHUNK % AUDIO_ADPCM_MAX_BLOCK == 0, "blok ADPCM harus membagi AUDIO_STREAM_CHUNK");
+static_assert(AUDIO_RING_CAPACITY % AUDIO_STREAM_CHUNK == 0, "AUDIO_RING_CAPACITY harus kelipatan AUDIO_STREAM_CHUNK");
+static_assert(LATENCY_BUCKETS <= 240, "LATENCY_BUCKETS maksimal 240 (index uint8)");
@@ -0,0 +1,110 @@
+#include "AudioLoader.h"
+#include "AudioPlayer.h"
+
+AudioLoader audioLoader;
+
+AudioLoader::AudioLoader() {}
+
+bool AudioLoader::begin(AudioPlayer *audioPlayer) {
+  player = audioPlayer;
+  if (queue) return true;
+
+  queue = xQueueCreate(AUDIO_LOADER_QUEUE, sizeof(AudioLoadJob));
+  if (!queue) {
+    Serial.println("❌ Audio loader queue gagal dibuat");
+    return false;
+  }
+
+  xTaskCreatePinnedToCore(
+    loaderTaskWrapper,
+    "AudioLoader",
+    6144,              // String path + JSON header + LittleFS
+    this,
+    AUDIO_LOADER_PRIORITY,
+    &loaderTaskHandle,
+    AUDIO_LOADER_CORE
+  );
+
+  Serial.println("✅ Audio loader ready");
+  return true;
+}
+
+// Load register dan aktifkan. Request sebelumnya yang belum selesai
+// otomatis batal. Dipanggil dari ADC task dan BLE task (beda core),
+// jadi naikkan seq di critical section.
+bool AudioLoader::request(const char *folderPath) {
+  portENTER_CRITICAL(&seqMux);
+  uint32_t seq = latestSeq + 1;
+  if (seq == 0) seq = 1;
+  latestSeq = seq;
+  portEXIT_CRITICAL(&seqMux);
+  return enqueue(folderPath, seq);
+}
+
+// Isi cache tanpa mengaktifkan (dikerjakan setelah request load)
+bool AudioLoader::preload(const char *folderPath) {
+  return enqueue(folderPath, 0);
+}
+
+bool AudioLoader::enqueue(const char *folderPath, uint32_t seq) {
+  if (!queue) return false;
+
+  AudioLoadJob job;
+  strncpy(job.folder, folderPath, sizeof(job.folder) - 1);
+  job.folder[sizeof(job.folder) - 1] = '\0';
+  job.seq = seq;
+
+  BaseType_t ok = (seq != 0) ? xQueueSendToFront(queue, &job, 0)
+                             : xQueueSendToBack(queue, &job, 0);
+  if (ok != pdTRUE) {
+    Serial.printf("⚠️ Audio loader queue penuh: %s\n", folderPath);
+    return false;
+  }
+  return true;
+}
+
+void AudioLoader::reportProgress(const AudioLoadJob &job, uint8_t loaded, uint8_t total) {
+  notify(job, LOAD_PROGRESS, loaded, total);
+}
+
+void AudioLoader::notify(const AudioLoadJob &job, AudioLoadState state,
+                         uint8_t loaded, uint8_t total) {
+  if (job.seq == 0 || !callback) return;  // preload tidak dilaporkan
+
+  AudioLoadStatus status;
+  status.folder = job.folder;
+  status.state = state;
+  status.loaded = loaded;
+  status.total = total;
+  callback(status);
+}
+
+void AudioLoader::loaderTaskWrapper(void *parameter) {
+  static_cast<AudioLoader *>(parameter)->loaderTask();
+}
+
+void AudioLoader::loaderTask() {
+  AudioLoadJob job;
+
+  for (;;) {
+    if (xQueueReceive(queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+    if (job.seq == 0) {
+      player->preloadRegister(job.folder);
+      continue;
+    }
+
+    // Sudah digantikan request lain sebelum sempat mulai
+    if (isCancelled(job)) {
+      notify(job, LOAD_CANCELLED, 0, 0);
+      continue;
+    }
+
+    bool ok = player->loadRegister(job.folder, &job);
+    if (ok) {
+      notify(job, LOAD_DONE, 0, 0);
+    } else {
+      notify(job, isCancelled(job) ? LOAD_CANCELLED : LOAD_FAILED, 0, 0);
+    }
+  }
+}
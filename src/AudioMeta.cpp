@@ -1,10 +1,21 @@
 #include "AudioMeta.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include "ImaAdpcm.h"
+#include "config.h"
 
-#define AUDIO_HEADER_MAXLEN 512
 AudioMetaManager audioMeta;
 
+// Baris header JSON = teks ASCII yang diakhiri newline; raw PCM hampir
+// pasti punya byte di luar itu
+static bool isHeaderText(const String &line) {
+    for (size_t i = 0; i < line.length(); i++) {
+        uint8_t c = line[i];
+        if ((c < 0x20 && c != '\t' && c != '\r') || c > 0x7E) return false;
+    }
+    return true;
+}
+
 bool AudioMetaManager::load(const char *path, AudioMeta &meta) {
     if (!path || strlen(path) == 0) {
         Serial.println("⚠️ Path kosong");
@@ -28,22 +39,39 @@ bool AudioMetaManager::load(const char *path, AudioMeta &meta) {
 
     meta.sample_rate = 8000;     // default 8kHz
     meta.sample_engine_rpm = 15000;
+    meta.load = 1;               // default on-throttle
+    meta.normalized = false;
+    meta.loopStart = 0;
+    meta.loopEnd = 0;
+    meta.format = AUDIO_FORMAT_PCM8;
+    meta.blockBytes = 0;
+    meta.granular = AUDIO_GRANULAR_DEFAULT;
+    meta.cycleRevs = 2;          // default 4-tak
+    meta.envelopes.mask = 0;
+    VehicleModel::defaultParams(meta.vehicle);
+    meta.shifts.mask = 0;
 
     meta.dataOffset = 0;
     meta.dataLength = file.size();
 
     // ===== ✅ COBA BACA METADATA JSON =====
-    if (file.available()) {
+    // Header hanya ada kalau byte pertama '{' - raw PCM tanpa header
+    // jangan dibaca sampai newline (bisa sebesar file)
+    if (file.available() && file.peek() == '{') {
         String header = file.readStringUntil('\n');
-        if (header.length() > AUDIO_HEADER_MAXLEN) {
-            header = header.substring(0, AUDIO_HEADER_MAXLEN);
-        }
 
         JsonDocument doc;
+        bool parsed = false;
+        if (header.length() > AUDIO_HEADER_MAXLEN) {
+            Serial.printf("❌ Header %s terlalu panjang (%u > %d byte)\n", path,
+                          header.length(), AUDIO_HEADER_MAXLEN);
+        } else {
+            DeserializationError err = deserializeJson(doc, header);
+            parsed = !err;
+            if (err) Serial.printf("❌ Header JSON %s invalid: %s\n", path, err.c_str());
+        }
 
-        DeserializationError err = deserializeJson(doc, header);
-
-        if (!err) {
+        if (parsed) {
             meta.title     = doc["title"]     | meta.title;
             meta.volume    = doc["volume"]    | meta.volume;
             meta.gearCount = doc["gearCount"] | meta.gearCount;
@@ -54,11 +82,70 @@ bool AudioMetaManager::load(const char *path, AudioMeta &meta) {
             meta.playable_max      = doc["playable_max"]      | meta.playable_max;
             meta.sample_rate       = doc["sample_rate"]       | meta.sample_rate;
             meta.sample_engine_rpm = doc["sample_engine_rpm"] | meta.sample_engine_rpm;
+            meta.load              = doc["load"]              | meta.load;
+            meta.normalized        = (doc["normalized"] | 0) != 0;
+
+            meta.loopStart         = doc["loop_start"]        | meta.loopStart;
+            meta.loopEnd           = doc["loop_end"]          | meta.loopEnd;
+
+            const char *format = doc["format"] | "pcm8";
+            if (strcmp(format, "adpcm") == 0) {
+                meta.format = AUDIO_FORMAT_ADPCM;
+                meta.blockBytes = doc["block"] | 256;
+            } else if (strcmp(format, "pcm8") != 0) {
+                Serial.printf("⚠️ Format tidak dikenal: %s (%s)\n", format, path);
+                file.close();
+                return false;
+            }
+
+            const char *mode = doc["mode"] | "";
+            if (strcmp(mode, "granular") == 0) meta.granular = true;
+            else if (strcmp(mode, "resample") == 0) meta.granular = false;
+            meta.cycleRevs = doc["cycle_revs"] | meta.cycleRevs;
+            if (meta.cycleRevs != 1) meta.cycleRevs = 2;
+
+            for (uint8_t i = 0; i < ENV_CURVE_COUNT; i++) {
+                const char *key = EnvelopeEngine::curveKey((EnvCurveId)i);
+                const char *curve = doc[key] | "";
+                if (!*curve) continue;
+                if (EnvelopeEngine::parseCurve(curve, meta.envelopes.curves[i])) {
+                    meta.envelopes.mask |= 1 << i;
+                } else {
+                    Serial.printf("⚠️ Kurva %s invalid: %s (%s)\n", key, curve, path);
+                }
+            }
+
+            // Drivetrain: 0/tidak ada = bawaan dari rentang RPM (VehicleModel)
+            const char *ratios = doc["gear_ratios"] | "";
+            if (*ratios && !VehicleModel::parseRatios(ratios, meta.vehicle)) {
+                Serial.printf("⚠️ gear_ratios invalid: %s (%s)\n", ratios, path);
+            }
+            meta.vehicle.revRate     = doc["rev_rate"]     | 0.0f;
+            meta.vehicle.engineBrake = doc["engine_brake"] | 0.0f;
+            meta.vehicle.inertia     = doc["inertia"]      | 0.0f;
+            meta.vehicle.shiftMs     = doc["shift_ms"]     | 0;
+            meta.vehicle.clutchMs    = doc["clutch_ms"]    | 0;
+
+            const char *up = doc["shift_up"] | "";
+            if (*up) {
+                if (AutoShift::parseTable(up, meta.shifts.up)) meta.shifts.mask |= SHIFT_SCHEDULE_UP;
+                else Serial.printf("⚠️ shift_up invalid: %s (%s)\n", up, path);
+            }
+            const char *down = doc["shift_down"] | "";
+            if (*down) {
+                if (AutoShift::parseTable(down, meta.shifts.down)) meta.shifts.mask |= SHIFT_SCHEDULE_DOWN;
+                else Serial.printf("⚠️ shift_down invalid: %s (%s)\n", down, path);
+            }
 
+            meta.dataOffset = file.position();
+            meta.dataLength = file.size() - meta.dataOffset;
+        } else if (isHeaderText(header)) {
+            // Header rusak: metadata bawaan, tapi baris JSON jangan ikut
+            // diputar sebagai audio
             meta.dataOffset = file.position();
             meta.dataLength = file.size() - meta.dataOffset;
         } else {
-            // fallback mode raw full
+            // fallback mode raw full (PCM yang kebetulan mulai 0x7B)
             file.seek(0);
             meta.dataOffset = 0;
             meta.dataLength = file.size();
@@ -66,6 +153,31 @@ bool AudioMetaManager::load(const char *path, AudioMeta &meta) {
     }
 
     file.close();
+
+    // Blok ADPCM harus power of 2 supaya pas di ring/chunk streaming
+    if (meta.format == AUDIO_FORMAT_ADPCM) {
+        uint32_t b = meta.blockBytes;
+        if (b < 64 || b > AUDIO_ADPCM_MAX_BLOCK || (b & (b - 1)) != 0) {
+            Serial.printf("⚠️ Blok ADPCM invalid: %lu (%s)\n", b, path);
+            return false;
+        }
+        meta.sampleCount = (meta.dataLength / b) * ImaAdpcm::samplesPerBlock(b);
+    } else {
+        meta.sampleCount = meta.dataLength;
+    }
+
+    // Rentang RPM model ikut field lama; rasio dari "gear_ratios" menang
+    // atas gearCount
+    meta.vehicle.idleRPM  = meta.playable_min > 65535 ? 65535 : meta.playable_min;
+    meta.vehicle.topRPM   = meta.playable_max > 65535 ? 65535 : meta.playable_max;
+    meta.vehicle.limitRPM = meta.maxRPM > 65535 ? 65535 : meta.maxRPM;
+    if (meta.vehicle.ratios[0] <= 0.0f) meta.vehicle.gearCount = meta.gearCount;
+
+    // Titik loop di luar data = anggap belum dianalisis
+    if (meta.loopEnd > meta.sampleCount || meta.loopStart >= meta.loopEnd) {
+        meta.loopStart = 0;
+        meta.loopEnd = 0;
+    }
     return true;
 }
 
@@ -79,10 +191,15 @@ void AudioMetaManager::print(const AudioMeta &meta) {
                   meta.playable_min, meta.playable_max);
 
     Serial.printf("🎚 Sample Rate: %lu Hz\n", meta.sample_rate);
-    Serial.printf("🚗 Engine RPM Ref: %lu\n", meta.sample_engine_rpm);
+    Serial.printf("🚗 Engine RPM Ref: %lu (%s-throttle)\n",
+                  meta.sample_engine_rpm, meta.load ? "on" : "off");
 
     Serial.printf("📦 Data Offset: %lu | Data Length: %lu\n",
                   meta.dataOffset, meta.dataLength);
+    Serial.printf("🔁 Loop: %lu - %lu (%lu sample, %s)\n", meta.loopStart, meta.loopEnd,
+                  meta.sampleCount, meta.format == AUDIO_FORMAT_ADPCM ? "adpcm" : "pcm8");
+    Serial.printf("🎛 Mode: %s (siklus %d putaran)\n", meta.granular ? "granular" : "resample",
+                  meta.cycleRevs);
 }
 
 
@@ -0,0 +1,210 @@
+#include "AudioNormalizer.h"
+#include "AudioMeta.h"
+#include "PCMNormalize.h"
+#include "LoopAnalyzer.h"
+#include <ArduinoJson.h>
+
+#define NORMALIZE_CHUNK 1024
+
+static uint8_t chunkBuf[NORMALIZE_CHUNK];  // milik pemegang fileMutex, bukan di stack BLE
+static SemaphoreHandle_t fileMutex = nullptr;
+
+// Dipanggil dari AudioPlayer::begin, sebelum BLE dan loader task jalan
+void AudioNormalizer::begin() {
+  if (!fileMutex) fileMutex = xSemaphoreCreateMutex();
+}
+
+bool AudioNormalizer::normalizeFile(const char *path) {
+  if (fileMutex) xSemaphoreTake(fileMutex, portMAX_DELAY);
+  bool ok = normalizeLocked(path);
+  if (fileMutex) xSemaphoreGive(fileMutex);
+  return ok;
+}
+
+// Normalisasi file langsung di LittleFS: pass 1 cari min/max per chunk,
+// analisis loop di potongan awal/akhir, pass 2 tulis header baru + data
+// ternormalisasi ke .norm lalu rename.
+bool AudioNormalizer::normalizeLocked(const char *path) {
+  AudioMeta meta;
+  if (!audioMeta.load(path, meta)) return false;
+  if (meta.normalized && meta.loopEnd > 0) return true;
+  if (meta.format != AUDIO_FORMAT_PCM8) return true;  // ADPCM dinormalisasi encoder
+  if (meta.dataLength == 0) return false;
+
+  String tmpPath = String(path) + ".norm";
+
+  File src = LittleFS.open(path, "r");
+  if (!src) {
+    Serial.printf("❌ Normalize: gagal buka %s\n", path);
+    return false;
+  }
+
+  // Pass 1: min/max
+  uint8_t minValue = 255;
+  uint8_t maxValue = 0;
+  src.seek(meta.dataOffset);
+  uint32_t remaining = meta.dataLength;
+  while (remaining > 0) {
+    size_t want = remaining < NORMALIZE_CHUNK ? remaining : NORMALIZE_CHUNK;
+    size_t got = src.read(chunkBuf, want);
+    if (got == 0) break;
+    PCMNormalize::findRange(chunkBuf, got, minValue, maxValue);
+    remaining -= got;
+  }
+  if (remaining > 0) {
+    src.close();
+    Serial.printf("❌ Normalize: read error %s\n", path);
+    return false;
+  }
+
+  // Pass 2: remap lewat tabel, tulis ulang
+  uint8_t lut[256];
+  PCMNormalize::buildLUT(minValue, maxValue, lut);
+
+  findLoopInFile(src, meta, lut);
+  String header = buildHeader(path, meta);
+
+  File dst = LittleFS.open(tmpPath, "w");
+  if (!dst) {
+    src.close();
+    Serial.printf("❌ Normalize: gagal buat %s\n", tmpPath.c_str());
+    return false;
+  }
+  dst.print(header);
+
+  src.seek(meta.dataOffset);
+  remaining = meta.dataLength;
+  bool ok = true;
+  while (remaining > 0) {
+    size_t want = remaining < NORMALIZE_CHUNK ? remaining : NORMALIZE_CHUNK;
+    size_t got = src.read(chunkBuf, want);
+    if (got == 0) { ok = false; break; }
+    PCMNormalize::applyLUT(chunkBuf, got, lut);
+    if (dst.write(chunkBuf, got) != got) { ok = false; break; }
+    remaining -= got;
+  }
+  src.close();
+  dst.close();
+
+  if (!ok) {
+    LittleFS.remove(tmpPath);
+    Serial.printf("❌ Normalize: write error %s\n", path);
+    return false;
+  }
+
+  if (!replaceFile(tmpPath, path)) return false;
+  Serial.printf("✅ Normalized: %s (range %d-%d, loop %lu-%lu)\n", path,
+                minValue, maxValue, meta.loopStart, meta.loopEnd);
+  return true;
+}
+
+// Titik loop dari potongan awal/akhir file (sudah di-remap lewat `lut`,
+// jadi sama dengan data yang akan ditulis). Gagal = loop seluruh data.
+void AudioNormalizer::findLoopInFile(File &src, AudioMeta &meta, const uint8_t lut[256]) {
+  uint32_t span = LoopAnalyzer::searchSpan(meta.dataLength);
+  LoopPoints loop = {0, meta.dataLength};
+
+  uint8_t *head = (uint8_t *)malloc(span * 2);
+  if (head && span > 0) {
+    uint8_t *tail = head + span;
+    uint32_t tailOffset = meta.dataLength - span;
+
+    src.seek(meta.dataOffset);
+    bool ok = src.read(head, span) == span;
+    src.seek(meta.dataOffset + tailOffset);
+    ok = ok && src.read(tail, span) == span;
+
+    if (ok) {
+      PCMNormalize::applyLUT(head, span, lut);
+      PCMNormalize::applyLUT(tail, span, lut);
+      if (!LoopAnalyzer::findInSegments(head, span, tail, span, tailOffset, loop)) {
+        loop.start = 0;
+        loop.end = meta.dataLength;
+      }
+    }
+  }
+  free(head);
+
+  meta.loopStart = loop.start;
+  meta.loopEnd = loop.end;
+}
+
+// Buffer di RAM belum ternormalisasi / belum punya titik loop (file lama,
+// upload via uploadfs): proses di tempat lalu simpan supaya load berikutnya
+// tidak perlu lagi
+bool AudioNormalizer::prepareAndWriteBack(const char *path, AudioMeta &meta,
+                                          uint8_t *data, size_t length) {
+  if (!meta.normalized) {
+    PCMNormalize::normalize(data, length);
+    meta.normalized = true;
+  }
+  if (meta.loopEnd == 0) {
+    LoopPoints loop = {0, (uint32_t)length};
+    if (!LoopAnalyzer::find(data, length, loop)) {
+      loop.start = 0;
+      loop.end = length;
+    }
+    meta.loopStart = loop.start;
+    meta.loopEnd = loop.end;
+  }
+
+  if (fileMutex) xSemaphoreTake(fileMutex, portMAX_DELAY);
+
+  // File di flash sudah diproses task lain, atau sudah diganti upload baru
+  // sejak dibaca: jangan ditimpa data lama
+  AudioMeta disk;
+  bool ok = audioMeta.load(path, disk) && disk.format == AUDIO_FORMAT_PCM8 &&
+            disk.dataLength == length && !(disk.normalized && disk.loopEnd > 0);
+  if (ok) {
+    String header = buildHeader(path, meta);
+    String tmpPath = String(path) + ".norm";
+
+    File dst = LittleFS.open(tmpPath, "w");
+    if (dst) {
+      dst.print(header);
+      ok = dst.write(data, length) == length;
+      dst.close();
+      if (ok) ok = replaceFile(tmpPath, path);
+      else LittleFS.remove(tmpPath);
+    } else {
+      ok = false;
+    }
+    if (!ok) Serial.printf("⚠️ Normalize write-back gagal: %s\n", path);
+  }
+
+  if (fileMutex) xSemaphoreGive(fileMutex);
+  return ok;
+}
+
+// Header JSON lama (kalau ada) + "normalized":1 + titik loop, diakhiri newline
+String AudioNormalizer::buildHeader(const char *path, const AudioMeta &meta) {
+  JsonDocument doc;
+
+  if (meta.dataOffset > 0) {
+    File f = LittleFS.open(path, "r");
+    if (f) {
+      String old = f.readStringUntil('\n');
+      f.close();
+      deserializeJson(doc, old);
+    }
+  }
+  doc["normalized"] = 1;
+  if (meta.loopEnd > 0) {
+    doc["loop_start"] = meta.loopStart;
+    doc["loop_end"] = meta.loopEnd;
+  }
+
+  String header;
+  serializeJson(doc, header);
+  header += '\n';
+  return header;
+}
+
+bool AudioNormalizer::replaceFile(const String &tmpPath, const char *path) {
+  LittleFS.remove(path);
+  if (!LittleFS.rename(tmpPath, path)) {
+    Serial.printf("❌ Failed to rename: %s -> %s\n", tmpPath.c_str(), path);
+    return false;
+  }
+  return true;
+}
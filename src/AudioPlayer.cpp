@@ -1,156 +1,485 @@
 #include "AudioPlayer.h"
 #include "config.h"
 #include "VolumeControl.h"
+#include "AudioStreamer.h"
+#include "AudioMeta.h"
+#include "AudioNormalizer.h"
+#include "LoopAnalyzer.h"
+#include "ImaAdpcm.h"
+#include "TimerDacSink.h"
+#include "I2SDacSink.h"
+#include "SoundBankCache.h"
+#include "AudioLoader.h"
+#include "EffectMixer.h"
+#include "EngineSynth.h"
+#include "DspChain.h"
+#include "EnvelopeEngine.h"
+#include "VehicleModel.h"
+#include "AutoShift.h"
+#include "LatencyProbe.h"
+#include "AudioProfiler.h"
 
-hw_timer_t *AudioPlayer::timer = nullptr;
-uint8_t *AudioPlayer::audioBuffer = nullptr;
-uint32_t AudioPlayer::audioLength = 0;
-volatile uint32_t AudioPlayer::index = 0;
+AudioSink *AudioPlayer::sink = nullptr;
+volatile uint32_t AudioPlayer::phaseFrac = 0;
+volatile uint32_t AudioPlayer::phaseIncrement = 0;
+volatile bool AudioPlayer::streaming = false;
+volatile bool AudioPlayer::engineOn = true;
+int32_t AudioPlayer::engineLevel = 0;
+volatile bool AudioPlayer::synthActive = false;
 uint32_t AudioPlayer::currentSampleRate = 8000;
+uint32_t AudioPlayer::engineRPM = 0;
+uint32_t AudioPlayer::streamRefRPM = 0;
+uint32_t AudioPlayer::streamSampleRate = 0;
+uint8_t AudioPlayer::currentLoad = 255;
+
+#if AUDIO_OUTPUT_BACKEND == AUDIO_BACKEND_I2S
+static I2SDacSink outputSink;
+#else
+static TimerDacSink outputSink;
+#endif
 VolumeControl* AudioPlayer::volumeCtrl = nullptr;
 
 // Konstruktor AudioPlayer
 AudioPlayer::AudioPlayer() {}
 
-// Normalisasi data PCM 8-bit agar amplitudo merata dan centered di 127
-// Mencari nilai min/max, lalu scale dan shift ke range 19-237
-/*✅ Perbaikan Variable Names:
-A → maxValue - Nilai maksimum dalam data
-B → minValue - Nilai minimum dalam data
-C → centerPoint - Titik tengah range
-X → dynamicRange - Range dinamis audio
-K → scaleFactor - Faktor skala normalisasi
-T → offset - Offset untuk centering
-Z → scaledCenter - Center point setelah scaling
-val → normalizedValue - Nilai setelah normalisasi
-*/
-void AudioPlayer::normalizePCM8(uint8_t *data, size_t length) {
-  if (!data || length == 0) return;
-
-  uint8_t maxValue = 0;
-  uint8_t minValue = 255;
-
-  // Find min/max values in audio data
-  for (size_t i = 0; i < length; i++) {
-    if (data[i] > maxValue) maxValue = data[i];
-    if (data[i] < minValue) minValue = data[i];
-  }
-
-  float centerPoint = (maxValue + minValue) * 0.5f;
-  float dynamicRange = (float)(maxValue - minValue);
-  float scaleFactor, offset;
-
-  if (dynamicRange < 2.0f) {
-    scaleFactor = 1.0f;
-    offset = 127.0f - centerPoint;
-  } else {
-    scaleFactor = 218.0f / dynamicRange;
-    float scaledCenter = centerPoint * scaleFactor;
-    offset = 127.0f - scaledCenter;
+// Render satu blok untuk output sink (dipanggil dari render task sink,
+// ISR/DMA hanya menyalin hasilnya). Sink jalan dengan rate tetap
+// AUDIO_OUTPUT_RATE. Sumber RAM di-mix oleh bank aktif di
+// SoundBankCache (multi-cell RPM x load); sumber streaming satu voice
+// dengan phaseIncrement 16.16 dan interpolasi linear. Semua sumber
+// menulis ke bus mix 16-bit, diproses DspChain (filter throttle, comb
+// knalpot), efek one-shot ditambahkan di atasnya, lalu
+// VolumeControl menerapkan gain dan kuantisasi (noise-shaped) ke kode
+// DAC 8-bit.
+void IRAM_ATTR AudioPlayer::renderSamples(uint8_t *out, size_t count) {
+  static int16_t mixBus[AUDIO_BLOCK_SAMPLES];
+
+  if (!volumeCtrl) {
+    memset(out, 128, count);
+    return;
   }
 
-  // Apply normalization to keep values in range 19-237
-  for (size_t i = 0; i < length; i++) {
-    float normalizedValue = (data[i] * scaleFactor) + offset;
-    if (normalizedValue < 19)  normalizedValue = 19;
-    if (normalizedValue > 237) normalizedValue = 237;
-    data[i] = (uint8_t)normalizedValue;
+  // Perubahan parameter sebelum blok ini mulai terdengar di blok ini
+  latencyProbe.onRender();
+
+  EngineSoundBank *bank = soundCache.active();
+  while (count > 0) {
+    size_t len = (count < AUDIO_BLOCK_SAMPLES) ? count : AUDIO_BLOCK_SAMPLES;
+
+    if (!engineOn && engineLevel == 0) {
+      memset(mixBus, 0, len * sizeof(int16_t));
+    } else if (streaming) {
+      renderStream(mixBus, len);
+    } else if (bank) {
+      bank->render(mixBus, len);
+      renderSwapFade(bank, mixBus, len);
+    } else if (synthActive) {
+      engineSynth.render(mixBus, len);
+    } else {
+      memset(mixBus, 0, len * sizeof(int16_t));
+    }
+    applyEngineFade(mixBus, len);
+    dspChain.process(mixBus, len);
+    effectMixer.render(mixBus, len);
+
+    volumeCtrl->processBlock(mixBus, out, len);
+    out += len;
+    count -= len;
   }
 }
 
-// ISR timer untuk output audio ke DAC
-// Dipanggil setiap interval sample rate (misal 16kHz = tiap 62.5μs)
-void IRAM_ATTR AudioPlayer::onTimerISR() {
-  if (!audioBuffer || audioLength == 0 || !volumeCtrl) {
-    dacWrite(AUDIO_DAC_PIN, 128);
-    return;
+void IRAM_ATTR AudioPlayer::renderStream(int16_t *out, size_t count) {
+  uint32_t frac = phaseFrac;
+  uint32_t inc = phaseIncrement;  // snapshot sekali per blok
+
+  // ADPCM: decode cukup blok untuk satu blok output (+2 untuk interpolasi)
+  audioStreamer.decodeAhead((uint32_t)(((uint64_t)count * inc + frac) >> AUDIO_PHASE_BITS) + 2);
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t acc = frac + inc;
+    uint32_t step = acc >> AUDIO_PHASE_BITS;
+
+    // Butuh sample sekarang + berikutnya untuk interpolasi
+    if (audioStreamer.available() < step + 2) {
+      audioStreamer.noteUnderrun();
+      out[i] = 0;
+      continue;
+    }
+    int32_t s0 = audioStreamer.peek(0);
+    int32_t s1 = audioStreamer.peek(1);
+    audioStreamer.consume(step);
+
+    // Linear interpolation ke 16-bit, bobot 8 bit dari fraksi phase
+    int32_t w = frac >> (AUDIO_PHASE_BITS - 8);
+    out[i] = (int16_t)((s0 - 128) * 256 + (s1 - s0) * w);
+    frac = acc & ((1UL << AUDIO_PHASE_BITS) - 1);
   }
 
-  if (index >= audioLength) index = 0;
-  
-  // Process audio through volume control
-  uint8_t sample = volumeCtrl->processAudioSample(audioBuffer[index]);
-  dacWrite(AUDIO_DAC_PIN, sample);
-  
-  index++;
+  phaseFrac = frac;
+}
+
+// Engine on/off di-fade (VOLUME_FADE_MS) supaya stopEngine saat efek
+// shutdown dan start berikutnya tidak pop
+void IRAM_ATTR AudioPlayer::applyEngineFade(int16_t *out, size_t count) {
+  const int32_t step = VOLUME_UNITY / (VOLUME_FADE_MS * AUDIO_OUTPUT_RATE / 1000);
+  int32_t level = engineLevel;
+  bool on = engineOn;
+  if (on ? level == VOLUME_UNITY : level == 0) return;
+
+  for (size_t i = 0; i < count; i++) {
+    if (on) level = (level + step < VOLUME_UNITY) ? level + step : VOLUME_UNITY;
+    else level = (level > step) ? level - step : 0;
+    out[i] = (int16_t)((out[i] * level) >> 15);
+  }
+  engineLevel = level;
 }
 
-// Inisialisasi DAC dan timer hardware untuk playback audio
-// Set sample rate default 16kHz
+// Crossfade linear dari bank sebelumnya ke bank aktif setelah swap
+// register. Swap dideteksi di sini (bank beda dari blok sebelumnya), jadi
+// task lain cukup ganti pointer. Bank lama terus dirender dari posisinya
+// sendiri sampai fade selesai; hanya dipakai selama masih jadi retired
+// bank di cache (kalau di-evict, fade langsung berhenti).
+void IRAM_ATTR AudioPlayer::renderSwapFade(EngineSoundBank *bank, int16_t *out, size_t count) {
+  static int16_t oldBuf[AUDIO_BLOCK_SAMPLES];
+  static EngineSoundBank *lastBank = nullptr;
+  static EngineSoundBank *fadeBank = nullptr;
+  static uint32_t remaining = 0;
+
+  EngineSoundBank *retired = soundCache.retired();
+  if (bank != lastBank) {
+    fadeBank = (lastBank && lastBank == retired) ? lastBank : nullptr;
+    remaining = fadeBank ? AUDIO_SWAP_FADE_SAMPLES : 0;
+    lastBank = bank;
+  }
+  if (remaining == 0 || fadeBank != retired) return;
+
+  EngineSoundBank *old = fadeBank;
+
+  while (count > 0 && remaining > 0) {
+    size_t len = (count < AUDIO_BLOCK_SAMPLES) ? count : AUDIO_BLOCK_SAMPLES;
+    old->render(oldBuf, len);
+
+    for (size_t i = 0; i < len && remaining > 0; i++, remaining--) {
+      int32_t d = (int32_t)oldBuf[i] - out[i];
+      out[i] = (int16_t)(out[i] + (d * (int32_t)remaining) / AUDIO_SWAP_FADE_SAMPLES);
+    }
+
+    out += len;
+    count -= len;
+  }
+}
+
+// Inisialisasi volume dan output sink (timer ISR atau I2S DMA)
+// Sink jalan tetap di AUDIO_OUTPUT_RATE, pitch default 8kHz (idle)
 void AudioPlayer::begin() {
-  dacWrite(AUDIO_DAC_PIN, 128);  // idle mid
   currentSampleRate = 8000;
+  phaseIncrement = rateToPhaseIncrement(currentSampleRate);
   
   volumeControl.begin();
-  volumeCtrl = &volumeControl;  // Set static pointer for ISR access
+  volumeCtrl = &volumeControl;  // Set static pointer for render access
+  dspChain.begin();
 
-  timer = timerBegin(0, 80, true);
-  timerAttachInterrupt(timer, &AudioPlayer::onTimerISR, true);
-  timerAlarmWrite(timer, 1000000 / 8000, true); // default 8kHz (idle)
-  timerAlarmEnable(timer);
+  if (outputSink.begin(AUDIO_OUTPUT_RATE, &AudioPlayer::renderSamples)) {
+    sink = &outputSink;
+#if AUDIO_PROFILER
+    audioProfiler.begin(sink, AUDIO_OUTPUT_RATE);
+#endif
+  } else {
+    Serial.println("❌ Audio output gagal start");
+  }
+  AudioNormalizer::begin();
+  soundCache.begin(sink);
+  effectMixer.begin(sink);
+  audioLoader.begin(this);
 }
 
-bool AudioPlayer::loadFile(const char *path) {
-  const uint32_t MAX_FILE_SIZE = 1048576; // 1MB
-  
-  if (timer) timerAlarmDisable(timer);
-  
-  cleanupAudioBuffer();
-  
-  File f = LittleFS.open(path, "r");
-  if (!f) {
-    Serial.printf("❌ Gagal buka %s\n", path);
-    return restoreTimer(false);
+// Load semua rekaman .raw di folder register. Register yang sudah ada di
+// cache langsung diaktifkan (ganti pointer, tanpa I/O). Kalau belum, file
+// dibaca ke slot cache sementara bank lama tetap diputar, lalu di-swap.
+// Folder dengan satu file besar (atau kalau RAM tidak cukup) di-stream
+// lewat AudioStreamer dan tidak masuk cache.
+// Lock cache hanya dipegang saat find/acquire/activate/drop; baca file
+// ke slot (ditandai filling) di luar lock, jadi invalidate dari BLE task
+// tidak menunggu I/O.
+// Biasanya dipanggil dari AudioLoader task; `job` dipakai untuk cek cancel
+// dan lapor progress per file.
+bool AudioPlayer::loadRegister(const char *folderPath, const AudioLoadJob *job) {
+  // find + activate satu lock supaya bank tidak di-evict di antaranya
+  soundCache.lock();
+  EngineSoundBank *cached = soundCache.find(folderPath);
+  if (cached) activateBank(cached);
+  soundCache.unlock();
+  if (cached) {
+    Serial.printf("⚡ Register cache hit: %s\n", folderPath);
+    return true;
   }
 
-  audioLength = f.size();
-  if (!isValidFileSize(audioLength, MAX_FILE_SIZE)) {
-    f.close();
-    return restoreTimer(false);
+  String paths[AUDIO_BANK_MAX_CELLS];
+  uint8_t count = scanRegister(folderPath, paths);
+  if (count == 0) return startSynth(folderPath);
+
+  AudioMeta meta;
+  bool single = (count == 1) && audioMeta.load(paths[0].c_str(), meta);
+  if (single && meta.sampleCount > AUDIO_STREAM_THRESHOLD) {
+    return streamRegister(paths[0].c_str(), meta);
   }
-  
-  if (!allocateBuffer() || !readFileData(f)) {
-    f.close();
-    return restoreTimer(false);
+
+  EngineSoundBank *bank = soundCache.acquire(folderPath);
+  if (!bank) {
+    Serial.printf("❌ Slot cache %s sedang diisi\n", folderPath);
+    return false;
   }
-  
-  f.close();
-  normalizePCM8(audioBuffer, audioLength);
-  index = 0;
-  
-  Serial.printf("✅ Loaded + normalized: %s (%lu bytes)\n", path, audioLength);
-  return restoreTimer(true);
+  if (fillBank(*bank, paths, count, job)) {
+    soundCache.lock();
+    activateBank(bank);
+    soundCache.commit(bank);
+    soundCache.unlock();
+    Serial.printf("✅ Sound bank %s: %d cell\n", folderPath, bank->getCellCount());
+
+    // Reload register aktif: slot lama dilepas setelah crossfade selesai
+    vTaskDelay(AUDIO_SWAP_RELEASE_MS / portTICK_PERIOD_MS);
+    soundCache.dropStale(folderPath);
+    return true;
+  }
+
+  soundCache.drop(bank);
+  bool cancelled = job && audioLoader.isCancelled(*job);
+  if (single && meta.dataLength > 0 && !cancelled) {
+    Serial.println("💡 Fallback ke streaming mode");
+    return streamRegister(paths[0].c_str(), meta);
+  }
+  return false;
+}
+
+// Isi cache untuk register yang tidak sedang diputar, hanya kalau muat
+// budget tanpa evict register lain. Register streaming dilewati.
+bool AudioPlayer::preloadRegister(const char *folderPath) {
+  if (soundCache.find(folderPath)) return true;
+
+  String paths[AUDIO_BANK_MAX_CELLS];
+  uint8_t count = scanRegister(folderPath, paths);
+  uint32_t total = 0;
+  bool cacheable = count > 0;
+
+  for (uint8_t i = 0; i < count && cacheable; i++) {
+    AudioMeta meta;
+    if (!audioMeta.load(paths[i].c_str(), meta)) continue;
+    if (count == 1 && meta.sampleCount > AUDIO_STREAM_THRESHOLD) cacheable = false;
+    total += meta.sampleCount;
+  }
+  if (!cacheable) return false;
+
+  // Cek budget dan ambil slot dalam satu lock (BLE invalidate/evict di task lain)
+  soundCache.lock();
+  EngineSoundBank *bank = soundCache.fits(total) ? soundCache.acquire(folderPath) : nullptr;
+  soundCache.unlock();
+  if (!bank) return false;
+  if (!fillBank(*bank, paths, count, nullptr)) {
+    soundCache.drop(bank);
+    return false;
+  }
+  soundCache.commit(bank);
+  Serial.printf("📦 Preloaded %s: %d cell (cache %lu KB)\n", folderPath,
+                bank->getCellCount(), soundCache.getUsedBytes() / 1024);
+  return true;
+}
+
+uint8_t AudioPlayer::scanRegister(const char *folderPath, String *paths) {
+  uint8_t count = 0;
+
+  File dir = LittleFS.open(folderPath);
+  if (dir && dir.isDirectory()) {
+    File file = dir.openNextFile();
+    while (file && count < AUDIO_BANK_MAX_CELLS) {
+      if (!file.isDirectory() && String(file.name()).endsWith(".raw")) {
+        paths[count++] = String(folderPath) + "/" + file.name();
+      }
+      file = dir.openNextFile();
+    }
+    dir.close();
+  }
+  return count;
+}
+
+// Tiap file jadi satu cell grid RPM x load; file yang terlalu besar untuk
+// RAM dilewati. Berhenti (bank tidak dipakai) kalau request dibatalkan.
+bool AudioPlayer::fillBank(EngineSoundBank &bank, String *paths, uint8_t count,
+                           const AudioLoadJob *job) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (job) {
+      if (audioLoader.isCancelled(*job)) return false;
+      audioLoader.reportProgress(*job, i, count);
+    }
+    AudioMeta meta;
+    if (!audioMeta.load(paths[i].c_str(), meta)) continue;
+    if (meta.sampleCount > AUDIO_STREAM_THRESHOLD) {
+      Serial.printf("⚠️ Skip %s: terlalu besar untuk bank (%lu sample)\n",
+                    paths[i].c_str(), meta.sampleCount);
+      continue;
+    }
+    loadCell(paths[i].c_str(), meta, bank);
+  }
+  return bank.getCellCount() > 0;
+}
+
+// Set pitch/load bank baru dulu supaya blok pertama sudah benar, lalu
+// swap pointer (render crossfade dari bank lama, lihat renderSwapFade).
+// Dari streaming: flag dimatikan dulu, tunggu blok yang masih membaca
+// stream selesai (pause/resume), baru streamer di-stop.
+void AudioPlayer::activateBank(EngineSoundBank *bank) {
+  bank->setLoad(currentLoad);
+  bank->setRPM(engineRPM ? engineRPM : bank->rateToRPM(currentSampleRate));
+  envelopes.setCurves(&bank->getEnvelopes());
+  vehicle.setParams(bank->getVehicle());
+  autoShift.setSchedule(&bank->getShifts());
+  soundCache.activate(bank);
+  if (streaming) {
+    streaming = false;
+    if (sink) {
+      sink->pause();
+      sink->resume();
+    }
+    audioStreamer.stop();
+  }
+  synthActive = false;
+}
+
+// Register kosong: engine synth dengan preset sesuai nomor register
+// ("/Audio" = 0, "/AudioN" = N). Tanpa I/O, langsung bunyi.
+bool AudioPlayer::startSynth(const char *folderPath) {
+  size_t len = strlen(folderPath);
+  char last = len ? folderPath[len - 1] : 0;
+  uint8_t preset = (last >= '0' && last <= '9') ? last - '0' : 0;
+
+  if (sink) sink->pause();
+  stopStreaming();
+  soundCache.activate(nullptr);
+  engineSynth.setPreset(preset);
+  engineSynth.setLoad(currentLoad);
+  engineSynth.setRPM(engineRPM ? engineRPM : engineSynth.rateToRPM(currentSampleRate));
+  envelopes.setCurves(nullptr);
+  VehicleParams params;
+  VehicleModel::defaultParams(params);
+  params.idleRPM = engineSynth.getPreset().idleRPM;
+  params.topRPM = params.limitRPM = engineSynth.getPreset().redlineRPM;
+  vehicle.setParams(params);
+  autoShift.setSchedule(nullptr);
+  synthActive = true;
+  Serial.printf("🎹 Register kosong %s, pakai engine synth: %s\n", folderPath,
+                engineSynth.getPreset().name);
+  return restoreOutput(true);
+}
+
+bool AudioPlayer::streamRegister(const char *path, const AudioMeta &meta) {
+  if (meta.granular) {
+    Serial.println("⚠️ Mode granular butuh rekaman di RAM, stream pakai resample");
+  }
+  if (sink) sink->pause();
+  stopStreaming();
+  soundCache.activate(nullptr);
+  synthActive = false;
+  envelopes.setCurves(&meta.envelopes);
+  vehicle.setParams(meta.vehicle);
+  autoShift.setSchedule(&meta.shifts);
+  return restoreOutput(startStreaming(path, meta));
 }
 
 // Mulai playback audio dari awal buffer
 void AudioPlayer::startPlayback() {
-  index = 0;
+  phaseFrac = 0;
+  engineOn = true;
   volumeControl.mute(false);
 }
 
-// Stop playback dan set DAC ke posisi idle (128)
+// Stop playback, render output idle (128) selama mute
 void AudioPlayer::stopPlayback() {
   volumeControl.mute(true);
-  dacWrite(AUDIO_DAC_PIN, 128);
+}
+
+// Diamkan loop engine saja, efek one-shot (mis. suara shutdown) tetap
+// terdengar. Pemanggil stopPlayback() setelah efek selesai.
+void AudioPlayer::stopEngine() {
+  engineOn = false;
 }
 
 // Set sample rate audio (8kHz - 44.1kHz)
-// Mengubah interval timer sesuai rate yang diinginkan
+// Timer tidak diprogram ulang: rate diubah jadi phase increment 16.16
+// relatif ke AUDIO_OUTPUT_RATE (streaming) atau RPM target sound bank.
+// Tulis 32-bit atomik, render langsung pakai tanpa reset phase.
 void AudioPlayer::setSampleRate(uint32_t rate) {
-  if (!timer) return;
+  engineRPM = 0;
+  rate = clampRate(rate);
 
-  if (rate < 8000) rate = 8000;
-  if (rate > 44100) rate = 44100;
-
-  // Only update timer if sample rate actually changed
   if (rate != currentSampleRate) {
     currentSampleRate = rate;
-    timerAlarmDisable(timer);
-    timerAlarmWrite(timer, 1000000 / rate, true);
-    timerAlarmEnable(timer);
+    applyPitch();
+  }
+}
+
+// Set RPM engine langsung (tanpa lewat skala sample rate). Disimpan
+// supaya bank/synth/stream yang diaktifkan berikutnya mulai di RPM ini.
+void AudioPlayer::setEngineRPM(uint32_t rpm) {
+  engineRPM = rpm;
+  if (streaming) {
+    if (streamRefRPM == 0) return;
+    uint32_t rate = clampRate((uint64_t)rpm * streamSampleRate / streamRefRPM);
+    if (rate != currentSampleRate) {
+      currentSampleRate = rate;
+      applyPitch();
+    }
+  } else {
+    EngineSoundBank *bank = soundCache.active();
+    if (bank) bank->setRPM(rpm);
+    else if (synthActive) engineSynth.setRPM(rpm);
+    dspChain.setRPM(rpm);
   }
 }
 
+// Load engine 0-255: 0 = off-throttle (decel), 255 = full on-throttle
+void AudioPlayer::setEngineLoad(uint8_t load) {
+  currentLoad = load;
+  EngineSoundBank *bank = soundCache.active();
+  if (bank) bank->setLoad(load);
+  else if (synthActive) engineSynth.setLoad(load);
+  dspChain.setLoad(load);
+}
+
+uint32_t AudioPlayer::getEngineRPM() {
+  if (streaming) {
+    if (streamSampleRate == 0) return 0;
+    return (uint32_t)(((uint64_t)currentSampleRate * streamRefRPM) / streamSampleRate);
+  }
+  EngineSoundBank *bank = soundCache.active();
+  if (bank) return bank->getRPM();
+  return synthActive ? engineSynth.getRPM() : 0;
+}
+
+uint8_t AudioPlayer::getActiveVoices() {
+  EngineSoundBank *bank = soundCache.active();
+  return bank ? bank->getActiveVoices() : 0;
+}
+
+void AudioPlayer::applyPitch() {
+  phaseIncrement = rateToPhaseIncrement(currentSampleRate);
+  if (!engineRPM) {
+    EngineSoundBank *bank = soundCache.active();
+    if (bank) bank->setRPM(bank->rateToRPM(currentSampleRate));
+    else if (synthActive) engineSynth.setRPM(engineSynth.rateToRPM(currentSampleRate));
+  }
+  dspChain.setRPM(getEngineRPM());
+}
+
+uint32_t AudioPlayer::clampRate(uint64_t rate) {
+  if (rate < 8000) return 8000;
+  if (rate > 44100) return 44100;
+  return (uint32_t)rate;
+}
+
+// Konversi sample rate sumber ke increment 16.16 per tick output
+uint32_t AudioPlayer::rateToPhaseIncrement(uint32_t rate) {
+  return (uint32_t)(((uint64_t)rate << AUDIO_PHASE_BITS) / AUDIO_OUTPUT_RATE);
+}
+
 // Update sample rate berdasarkan nilai ADC (0-4095)
 // Map ADC value ke range 8kHz - 44.1kHz
 void AudioPlayer::updateSampleRateFromADC(int adcValue) {
@@ -180,45 +509,162 @@ uint32_t AudioPlayer::getSampleRate() {
   return currentSampleRate;
 }
 
-void AudioPlayer::cleanupAudioBuffer() {
-  if (audioBuffer) {
-    free(audioBuffer);
-    audioBuffer = nullptr;
-    audioLength = 0;
+const char *AudioPlayer::getOutputBackend() {
+  return sink ? sink->name() : "none";
+}
+
+// Jumlah sample output yang kehabisan data ring (0 di mode RAM)
+uint32_t AudioPlayer::getUnderrunCount() {
+  return audioStreamer.getUnderruns();
+}
+
+// Jumlah tick output yang tidak punya blok siap (render task telat)
+uint32_t AudioPlayer::getOutputUnderruns() {
+  return sink ? sink->getUnderruns() : 0;
+}
+
+// Baca satu rekaman ke RAM/PSRAM (ADPCM di-decode ke PCM 8-bit) lalu
+// tambahkan ke bank
+bool AudioPlayer::loadCell(const char *path, AudioMeta &meta, EngineSoundBank &bank) {
+  const uint32_t MAX_FILE_SIZE = 1048576; // 1MB (mode RAM)
+
+  if (!isValidFileSize(meta.sampleCount, MAX_FILE_SIZE)) {
+    return false;
   }
+
+  File f = LittleFS.open(path, "r");
+  if (!f) {
+    Serial.printf("❌ Gagal buka %s\n", path);
+    return false;
+  }
+
+  uint8_t *buffer = soundCache.allocate(meta.sampleCount, &bank);
+  if (!buffer) {
+    f.close();
+    return false;
+  }
+
+  f.seek(meta.dataOffset);
+  bool ok = (meta.format == AUDIO_FORMAT_ADPCM)
+              ? readAdpcmData(f, meta, buffer)
+              : readFileData(f, buffer, meta.dataLength);
+  f.close();
+  if (!ok) {
+    free(buffer);
+    return false;
+  }
+
+  // Normalisasi + titik loop sudah dicari saat upload; file PCM lama
+  // diproses sekali di sini lalu ditulis balik ke header. ADPCM sudah
+  // dinormalisasi encoder; titik loop yang belum ada dicari di RAM saja.
+  if (meta.format == AUDIO_FORMAT_PCM8) {
+    if (!meta.normalized || meta.loopEnd == 0) {
+      AudioNormalizer::prepareAndWriteBack(path, meta, buffer, meta.dataLength);
+    }
+  } else if (meta.loopEnd == 0) {
+    LoopPoints loop;
+    if (LoopAnalyzer::find(buffer, meta.sampleCount, loop)) {
+      meta.loopStart = loop.start;
+      meta.loopEnd = loop.end;
+    }
+  }
+
+  // Crossfade tail hanya di RAM, file tetap data asli
+  if (meta.loopEnd > 0) {
+    LoopPoints loop = {meta.loopStart, meta.loopEnd};
+    LoopAnalyzer::applyCrossfadeTail(buffer, loop, AUDIO_LOOP_XFADE_SAMPLES);
+  }
+
+  if (!bank.addCell(buffer, meta.sampleCount, meta)) {
+    free(buffer);
+    return false;
+  }
+
+  Serial.printf("✅ Loaded: %s (%lu sample, %lu RPM, %s, loop %lu-%lu%s)\n", path,
+                meta.sampleCount, meta.sample_engine_rpm, meta.load ? "on" : "off",
+                meta.loopStart, meta.loopEnd,
+                meta.format == AUDIO_FORMAT_ADPCM ? ", adpcm" : "");
+  return true;
 }
 
 bool AudioPlayer::isValidFileSize(uint32_t size, uint32_t maxSize) {
   if (size == 0 || size > maxSize) {
     Serial.printf("❌ Ukuran file invalid: %lu bytes\n", size);
-    audioLength = 0;
     return false;
   }
   return true;
 }
 
-bool AudioPlayer::allocateBuffer() {
-  audioBuffer = (uint8_t *)malloc(audioLength);
-  if (!audioBuffer) {
-    Serial.println("❌ RAM tidak cukup");
-    audioLength = 0;
+bool AudioPlayer::readFileData(File& f, uint8_t *buffer, uint32_t length) {
+  size_t bytesRead = f.read(buffer, length);
+  if (bytesRead != length) {
+    Serial.printf("❌ Read error: expected %lu, got %lu\n", length, bytesRead);
     return false;
   }
   return true;
 }
 
-bool AudioPlayer::readFileData(File& f) {
-  size_t bytesRead = f.read(audioBuffer, audioLength);
-  if (bytesRead != audioLength) {
-    Serial.printf("❌ Read error: expected %lu, got %lu\n", audioLength, bytesRead);
-    cleanupAudioBuffer();
+// Decode blok demi blok langsung ke buffer sample
+bool AudioPlayer::readAdpcmData(File& f, const AudioMeta &meta, uint8_t *buffer) {
+  static uint8_t block[AUDIO_ADPCM_MAX_BLOCK];  // hanya dipakai loader task
+
+  uint32_t blocks = meta.dataLength / meta.blockBytes;
+  for (uint32_t b = 0; b < blocks; b++) {
+    if (f.read(block, meta.blockBytes) != meta.blockBytes) {
+      Serial.printf("❌ Read error: blok ADPCM %lu/%lu\n", b, blocks);
+      return false;
+    }
+    buffer += ImaAdpcm::decodeBlock(block, meta.blockBytes, buffer);
+  }
+  return true;
+}
+
+bool AudioPlayer::startStreaming(const char *path, const AudioMeta &fileMeta) {
+  AudioMeta meta = fileMeta;
+
+  // File besar belum ternormalisasi: normalisasi sekali di flash (header
+  // berubah, jadi meta dibaca ulang untuk dataOffset yang baru)
+  if (meta.format == AUDIO_FORMAT_PCM8 && !meta.normalized &&
+      AudioNormalizer::normalizeFile(path)) {
+    audioMeta.load(path, meta);
+  }
+
+  // Loop di antara titik loop (file lama tanpa analisis: seluruh data),
+  // dikonversi ke byte. ADPCM hanya bisa loop di batas blok.
+  uint32_t loopStart = meta.loopStart;
+  uint32_t loopEnd = meta.loopEnd ? meta.loopEnd : meta.sampleCount;
+  uint32_t adpcmBlock = 0;
+  if (meta.format == AUDIO_FORMAT_ADPCM) {
+    uint32_t spb = ImaAdpcm::samplesPerBlock(meta.blockBytes);
+    adpcmBlock = meta.blockBytes;
+    loopStart = (loopStart / spb) * adpcmBlock;
+    loopEnd = (loopEnd / spb) * adpcmBlock;
+    if (loopEnd <= loopStart) {
+      loopStart = 0;
+      loopEnd = (meta.dataLength / adpcmBlock) * adpcmBlock;
+    }
+  }
+
+  phaseFrac = 0;
+  if (!audioStreamer.start(path, meta.dataOffset, loopEnd, loopStart, adpcmBlock)) {
     return false;
   }
+  streamRefRPM = meta.sample_engine_rpm;
+  streamSampleRate = meta.sample_rate;
+  if (engineRPM && streamRefRPM) {
+    currentSampleRate = clampRate((uint64_t)engineRPM * streamSampleRate / streamRefRPM);
+  }
+  applyPitch();
+  streaming = true;
   return true;
 }
 
-bool AudioPlayer::restoreTimer(bool success) {
-  if (timer) timerAlarmEnable(timer);
-  return success;
+void AudioPlayer::stopStreaming() {
+  streaming = false;
+  audioStreamer.stop();
 }
 
+bool AudioPlayer::restoreOutput(bool success) {
+  if (sink) sink->resume();
+  return success;
+}
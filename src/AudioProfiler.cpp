@@ -0,0 +1,123 @@
+#include "AudioProfiler.h"
+
+#if AUDIO_PROFILER
+#include <esp_timer.h>
+#include "AudioSink.h"
+
+AudioProfiler audioProfiler;
+
+void IRAM_ATTR CycleStats::add(uint32_t cycles) {
+  count++;
+  totalCycles += cycles;
+  if (cycles < minCycles) minCycles = cycles;
+  if (cycles > maxCycles) maxCycles = cycles;
+  hist[cycles ? 32 - __builtin_clz(cycles) : 0]++;
+}
+
+void CycleStats::clear() {
+  memset(this, 0, sizeof(*this));
+  minCycles = UINT32_MAX;
+}
+
+AudioProfiler::AudioProfiler() {
+  isr.clear();
+  render.clear();
+}
+
+void AudioProfiler::begin(AudioSink *outputSink, uint32_t sampleRate) {
+  sink = outputSink;
+  cpuMHz = ESP.getCpuFreqMHz();
+  periodCycles = sampleRate ? cpuMHz * 1000000UL / sampleRate : 0;
+  blockCycles = periodCycles * AUDIO_BLOCK_SAMPLES;
+  reset();
+  Serial.printf("✅ Audio profiler: %lu cycle/sample, %lu cycle/blok\n", periodCycles, blockCycles);
+}
+
+// Dipanggil di akhir ISR sample. Jarak antar awal ISR dibandingkan dengan
+// periode: lebih dari 1.5 periode = telat, kelipatannya = periode hilang.
+// Overhead dispatch interrupt (sebelum BEGIN) tidak ikut terhitung.
+// Build host (offline_render): ISR selalu tepat di tick virtual, jarak
+// antar ISR hanya berisi jitter OS host, jadi late/missed tidak dihitung.
+void IRAM_ATTR AudioProfiler::endIsr(uint32_t startCycles) {
+  isr.add(ESP.getCycleCount() - startCycles);
+
+#ifdef ESP_PLATFORM
+  if (lastIsrStart && periodCycles) {
+    uint32_t interval = startCycles - lastIsrStart;
+    if (interval > periodCycles + periodCycles / 2) {
+      latePeriods++;
+      missedPeriods += (interval + periodCycles / 2) / periodCycles - 1;
+    }
+  }
+  lastIsrStart = startCycles;
+#endif
+}
+
+void IRAM_ATTR AudioProfiler::endRender(uint32_t startCycles) {
+  uint32_t cycles = ESP.getCycleCount() - startCycles;
+  render.add(cycles);
+  if (blockCycles && cycles > blockCycles) renderOverruns++;
+}
+
+static void appendStats(String &out, const char *name, const CycleStats &s, uint32_t mhz) {
+  char line[96];
+  if (s.count == 0) {
+    snprintf(line, sizeof(line), "%s n=0\n", name);
+    out += line;
+    return;
+  }
+  uint32_t avg = (uint32_t)(s.totalCycles / s.count);
+  snprintf(line, sizeof(line), "%s n=%lu cyc min=%lu avg=%lu max=%lu (max %.1f us)\n", name,
+           (unsigned long)s.count, (unsigned long)s.minCycles, (unsigned long)avg,
+           (unsigned long)s.maxCycles, (float)s.maxCycles / mhz);
+  out += line;
+
+  // Histogram: "<2^n:count" untuk bucket yang terisi
+  out += " hist";
+  for (uint8_t b = 0; b < 33; b++) {
+    if (!s.hist[b]) continue;
+    snprintf(line, sizeof(line), " <%lu:%lu", b < 32 ? (unsigned long)(1UL << b) : 0xFFFFFFFFUL,
+             (unsigned long)s.hist[b]);
+    out += line;
+  }
+  out += "\n";
+}
+
+// Fraksi CPU = cycle ISR + render dibagi cycle core selama jendela sejak
+// reset (waktu dari esp_timer 64-bit, CCOUNT wrap tiap ~18 detik di 240MHz)
+String AudioProfiler::report() {
+  String out;
+  char line[96];
+
+  uint64_t elapsed = (uint64_t)(esp_timer_get_time() - resetTime) * cpuMHz;
+  uint64_t busy = isr.totalCycles + render.totalCycles;
+  float cpu = elapsed ? (float)busy * 100.0f / (float)elapsed : 0.0f;
+  uint32_t underruns = sink ? sink->getUnderruns() - underrunBase : 0;
+
+  snprintf(line, sizeof(line), "audio cpu=%.1f%% late=%lu missed=%lu overrun=%lu underrun=%lu\n",
+           cpu, (unsigned long)latePeriods, (unsigned long)missedPeriods,
+           (unsigned long)renderOverruns, (unsigned long)underruns);
+  out += line;
+  appendStats(out, "isr", isr, cpuMHz);
+  appendStats(out, "render", render, cpuMHz);
+  return out;
+}
+
+void AudioProfiler::printReport() {
+  Serial.printf("📈 Audio profiler (cpu = %% satu core, budget %lu cycle/sample, %lu cycle/blok):\n%s",
+                (unsigned long)periodCycles, (unsigned long)blockCycles, report().c_str());
+}
+
+// Statistik bisa sedikit tidak konsisten kalau ISR masuk di tengah reset
+void AudioProfiler::reset() {
+  isr.clear();
+  render.clear();
+  lastIsrStart = 0;
+  latePeriods = 0;
+  missedPeriods = 0;
+  renderOverruns = 0;
+  underrunBase = sink ? sink->getUnderruns() : 0;
+  resetTime = esp_timer_get_time();
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include "AudioStreamer.h"
+#include "ImaAdpcm.h"
+
+AudioStreamer audioStreamer;
+
+AudioStreamer::AudioStreamer() {}
+
+// Alokasi ring buffer dan start reader task (Core 1, di atas BLE task)
+bool AudioStreamer::begin() {
+  if (ring) return true;
+
+  ring = (uint8_t *)malloc(AUDIO_RING_CAPACITY);
+  pcm = (uint8_t *)malloc(AUDIO_ADPCM_FIFO + ImaAdpcm::samplesPerBlock(AUDIO_ADPCM_MAX_BLOCK));
+  if (!ring || !pcm) {
+    free(ring);
+    free(pcm);
+    ring = nullptr;
+    pcm = nullptr;
+    Serial.println("❌ RAM tidak cukup untuk ring buffer streaming");
+    return false;
+  }
+  memset(ring, 128, AUDIO_RING_CAPACITY);
+  decodeBuf = pcm + AUDIO_ADPCM_FIFO;
+
+  fileMutex = xSemaphoreCreateMutex();
+
+  xTaskCreatePinnedToCore(
+    readerTaskWrapper,
+    "AudioReader",
+    4096,
+    this,
+    3,                 // Di atas BLE task, refill tidak boleh kelaparan
+    &readerTaskHandle,
+    1                  // Core 1, jauh dari ADC task
+  );
+
+  Serial.printf("✅ Audio streamer ready (ring %d KB)\n", AUDIO_RING_CAPACITY / 1024);
+  return true;
+}
+
+// Buka file, isi ring sampai penuh, lalu aktifkan reader task.
+// Dipanggil saat output sink di-pause (lihat AudioPlayer::streamRegister).
+// `length` = akhir loop, setelah itu baca lanjut dari `loop` (byte, relatif
+// ke offset). `adpcmBlock` != 0: data IMA-ADPCM, loop harus di batas blok.
+bool AudioStreamer::start(const char *path, uint32_t offset, uint32_t length,
+                          uint32_t loop, uint32_t adpcmBlock) {
+  if (!begin()) return false;
+  stop();
+
+  if (length == 0 || loop >= length) {
+    Serial.printf("❌ Stream kosong: %s\n", path);
+    return false;
+  }
+
+  xSemaphoreTake(fileMutex, portMAX_DELAY);
+  file = LittleFS.open(path, "r");
+  if (!file) {
+    xSemaphoreGive(fileMutex);
+    Serial.printf("❌ Gagal buka stream %s\n", path);
+    return false;
+  }
+
+  dataOffset = offset;
+  dataLength = length;
+  loopStart = loop;
+  dataPos = 0;
+  head = 0;
+  tail = 0;
+  blockBytes = adpcmBlock;
+  pcmHead = 0;
+  pcmTail = 0;
+  file.seek(dataOffset);
+
+  // Prefill supaya playback mulai dengan buffer penuh
+  bool ok = true;
+  while (ok && freeSpace() >= AUDIO_STREAM_CHUNK) {
+    ok = fillChunk();
+  }
+  xSemaphoreGive(fileMutex);
+
+  if (!ok) {
+    stop();
+    return false;
+  }
+
+  resetStats();
+  active = true;
+  xTaskNotifyGive(readerTaskHandle);
+
+  Serial.printf("✅ Streaming: %s (%lu bytes, offset %lu)\n", path, dataLength, dataOffset);
+  return true;
+}
+
+// Matikan reader dan tutup file. Tunggu baca yang sedang jalan selesai.
+void AudioStreamer::stop() {
+  active = false;
+  if (!fileMutex) return;
+
+  xSemaphoreTake(fileMutex, portMAX_DELAY);
+  if (file) file.close();
+  head = 0;
+  tail = 0;
+  pcmHead = 0;
+  pcmTail = 0;
+  xSemaphoreGive(fileMutex);
+}
+
+// Render: decode blok ADPCM dari ring sampai FIFO punya `needed` sample
+// (atau ring/FIFO habis). Blok selalu utuh dan tidak terpotong batas ring
+// karena ring kelipatan chunk dan chunk kelipatan blok.
+void IRAM_ATTR AudioStreamer::decodeAhead(uint32_t needed) {
+  if (!blockBytes) return;
+
+  uint32_t spb = ImaAdpcm::samplesPerBlock(blockBytes);
+  while (pcmHead - pcmTail < needed &&
+         AUDIO_ADPCM_FIFO - (pcmHead - pcmTail) >= spb &&
+         head - tail >= blockBytes) {
+    const uint8_t *block = ring + (tail & (AUDIO_RING_CAPACITY - 1));
+    ImaAdpcm::decodeBlock(block, blockBytes, decodeBuf);
+    tail += blockBytes;
+
+    for (uint32_t i = 0; i < spb; i++) {
+      pcm[(pcmHead + i) & (AUDIO_ADPCM_FIFO - 1)] = decodeBuf[i];
+    }
+    pcmHead += spb;
+  }
+}
+
+void AudioStreamer::resetStats() {
+  underruns = 0;
+  reportedUnderruns = 0;
+  refills = 0;
+}
+
+// Baca satu chunk ke ring. Head selalu chunk-aligned karena capacity
+// kelipatan chunk dan chunk selalu diisi penuh (lanjut setelah seek loop).
+bool AudioStreamer::fillChunk() {
+  uint32_t remaining = AUDIO_STREAM_CHUNK;
+
+  while (remaining > 0) {
+    uint32_t untilEnd = dataLength - dataPos;
+    uint32_t want = (remaining < untilEnd) ? remaining : untilEnd;
+    uint8_t *dst = ring + (head & (AUDIO_RING_CAPACITY - 1));
+
+    size_t got = file.read(dst, want);
+    if (got == 0) {
+      Serial.printf("❌ Stream read error @%lu\n", dataPos);
+      return false;
+    }
+
+    __sync_synchronize();  // data ring harus terlihat sebelum head maju
+    head += got;
+    remaining -= got;
+    dataPos += got;
+
+    // Loop: seek balik ke titik loop
+    if (dataPos >= dataLength) {
+      dataPos = loopStart;
+      file.seek(dataOffset + loopStart);
+    }
+  }
+
+  refills++;
+  return true;
+}
+
+void AudioStreamer::readerTaskWrapper(void *parameter) {
+  static_cast<AudioStreamer *>(parameter)->readerTask();
+}
+
+void AudioStreamer::readerTask() {
+  for (;;) {
+    if (!active) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    while (active && freeSpace() >= AUDIO_STREAM_CHUNK) {
+      if (!fillChunk()) {
+        active = false;
+        break;
+      }
+    }
+    xSemaphoreGive(fileMutex);
+
+    // Laporkan underrun baru (render hanya menaikkan counter), max 1x/detik
+    uint32_t u = underruns;
+    unsigned long now = millis();
+    if (u != reportedUnderruns && now - lastReport >= 1000) {
+      Serial.printf("⚠️ Stream underrun: %lu sample (refill %lu)\n", u, refills);
+      reportedUnderruns = u;
+      lastReport = now;
+    }
+
+    // 32KB ring = ~670ms audio di rate maksimum, polling 5ms cukup
+    vTaskDelay(5 / portTICK_PERIOD_MS);
+  }
+}
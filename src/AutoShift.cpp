@@ -0,0 +1,146 @@
+#include "AutoShift.h"
+#include "VehicleModel.h"
+
+AutoShift autoShift;
+
+#define HISTORY_LEN (AUTOSHIFT_KICKDOWN_MS / AUTOSHIFT_TICK_MS)
+
+AutoShift::AutoShift() {
+  memset(&source, 0, sizeof(source));
+  memset(&active, 0, sizeof(active));
+  memset(history, 0, sizeof(history));
+}
+
+// "7000,9000,12000,14000;8000,..." : baris per gigi dipisah ';', tiap baris
+// AUTOSHIFT_THROTTLE_BINS nilai RPM. Baris yang tidak ditulis mengulang
+// baris terakhir.
+bool AutoShift::parseTable(const char *text, uint16_t table[][AUTOSHIFT_THROTTLE_BINS]) {
+  uint16_t rows[VEHICLE_MAX_GEARS][AUTOSHIFT_THROTTLE_BINS];
+  uint8_t row = 0, col = 0;
+  const char *s = text;
+
+  while (*s) {
+    char *end;
+    long rpm = strtol(s, &end, 10);
+    if (end == s || rpm <= 0 || rpm > 65535) return false;
+    if (row >= VEHICLE_MAX_GEARS || col >= AUTOSHIFT_THROTTLE_BINS) return false;
+    rows[row][col++] = (uint16_t)rpm;
+    s = end;
+    if (*s == ',') {
+      s++;
+    } else if (*s == ';' || !*s) {
+      if (col != AUTOSHIFT_THROTTLE_BINS) return false;
+      row++;
+      col = 0;
+      if (*s) s++;
+    } else {
+      return false;
+    }
+  }
+
+  if (row == 0 || col != 0) return false;
+  for (uint8_t r = 0; r < VEHICLE_MAX_GEARS; r++) {
+    memcpy(table[r], rows[r < row ? r : row - 1], sizeof(rows[0]));
+  }
+  return true;
+}
+
+void AutoShift::setSchedule(const ShiftSchedule *schedule) {
+  portENTER_CRITICAL(&mux);
+  if (schedule) source = *schedule;
+  else source.mask = 0;
+  sourcePending = true;
+  portEXIT_CRITICAL(&mux);
+}
+
+void AutoShift::setEnabled(bool on) {
+  enabled = on;
+  Serial.printf("⚙️ Auto shift %s\n", on ? "ON" : "OFF");
+}
+
+// Tabel aktif = aset atau bawaan dari rentang RPM model, lalu titik
+// downshift dibatasi supaya di bawah RPM setelah upshift (histeresis)
+void AutoShift::rebuild() {
+  portENTER_CRITICAL(&mux);
+  ShiftSchedule src = source;
+  sourcePending = false;
+  portEXIT_CRITICAL(&mux);
+
+  uint32_t idle = vehicle.getIdleRPM();
+  uint32_t span = vehicle.getLimitRPM() - idle;
+  uint8_t gears = vehicle.getGearCount();
+
+  for (uint8_t g = 0; g < VEHICLE_MAX_GEARS; g++) {
+    for (uint8_t t = 0; t < AUTOSHIFT_THROTTLE_BINS; t++) {
+      // Bawaan: naik di 35% (gas tutup) .. 90% (gas penuh) rentang,
+      // turun di 15% .. 45%
+      uint32_t pos = t * 1000 / (AUTOSHIFT_THROTTLE_BINS - 1);
+      active.up[g][t] = (src.mask & SHIFT_SCHEDULE_UP) ? src.up[g][t]
+                        : idle + span * (350 + 550 * pos / 1000) / 1000;
+      active.down[g][t] = (src.mask & SHIFT_SCHEDULE_DOWN) ? src.down[g][t]
+                          : idle + span * (150 + 300 * pos / 1000) / 1000;
+    }
+  }
+
+  for (uint8_t g = 2; g <= gears; g++) {
+    uint32_t lower = vehicle.getRatioPermil(g - 1);
+    uint32_t upper = vehicle.getRatioPermil(g);
+    if (lower == 0) continue;
+    for (uint8_t t = 0; t < AUTOSHIFT_THROTTLE_BINS; t++) {
+      uint32_t landing = active.up[g - 2][t] * upper / lower;
+      uint32_t limit = landing > AUTOSHIFT_HYST_RPM ? landing - AUTOSHIFT_HYST_RPM : 0;
+      if (active.down[g - 1][t] > limit) active.down[g - 1][t] = limit;
+    }
+  }
+  builtVersion = vehicle.getParamsVersion();
+}
+
+// Interpolasi linear antar kolom, throttle 0-4095 (Q12)
+uint16_t AutoShift::lookup(const uint16_t *row, uint16_t throttle) {
+  uint32_t pos = (uint32_t)throttle * (AUTOSHIFT_THROTTLE_BINS - 1);
+  uint32_t idx = pos >> 12;
+  if (idx >= AUTOSHIFT_THROTTLE_BINS - 1) return row[AUTOSHIFT_THROTTLE_BINS - 1];
+  int32_t frac = pos & 0xFFF;
+  int32_t a = row[idx], b = row[idx + 1];
+  return (uint16_t)(a + (b - a) * frac / 4096);
+}
+
+uint8_t AutoShift::update(uint32_t nowMs) {
+  if (nowMs - lastTick < AUTOSHIFT_TICK_MS) return 0;
+  lastTick = nowMs;
+
+  if (sourcePending || builtVersion != vehicle.getParamsVersion()) rebuild();
+
+  uint16_t throttle = vehicle.getThrottle();
+  uint16_t oldest = throttle;
+  for (uint8_t i = 0; i < HISTORY_LEN; i++) {
+    if (history[i] < oldest) oldest = history[i];
+  }
+  history[historyPos] = throttle;
+  historyPos = (historyPos + 1) % HISTORY_LEN;
+
+  uint8_t gear = vehicle.getGear();
+  if (!enabled || gear == 0 || vehicle.isShifting()) return 0;
+
+  uint32_t rpm = vehicle.getRPM();
+  uint8_t gears = vehicle.getGearCount();
+
+  // Kickdown: gigi terendah yang RPM hasilnya masih di bawah titik upshift
+  if (throttle >= AUTOSHIFT_KICKDOWN_MIN && throttle - oldest >= AUTOSHIFT_KICKDOWN_DELTA && gear > 1) {
+    uint32_t from = vehicle.getRatioPermil(gear);
+    uint8_t target = gear;
+    for (uint8_t g = gear - 1; g >= 1; g--) {
+      uint32_t landing = rpm * vehicle.getRatioPermil(g) / from;
+      if (landing + AUTOSHIFT_HYST_RPM >= lookup(active.up[g - 1], throttle)) break;
+      target = g;
+    }
+    for (uint8_t i = 0; i < HISTORY_LEN; i++) history[i] = throttle;
+    if (target != gear) return target;
+  }
+
+  if (nowMs - lastShiftMs < AUTOSHIFT_MIN_DWELL_MS) return 0;
+
+  if (gear < gears && rpm >= lookup(active.up[gear - 1], throttle)) return gear + 1;
+  if (gear > 1 && rpm <= lookup(active.down[gear - 1], throttle)) return gear - 1;
+  return 0;
+}
@@ -1,10 +1,16 @@
 #include "BLEControl.h"
+#include "AudioNormalizer.h"
+#include "SoundBankCache.h"
+#include "EffectMixer.h"
+#include "LatencyProbe.h"
+#include "AudioProfiler.h"
 
 const int MAX_GEAR = 4;
 const int MIN_GEAR = 0;
 
 NimBLECharacteristic* BLEControl::pCharacteristic = nullptr;
 NimBLECharacteristic* BLEControl::pFileCharacteristic = nullptr;
+NimBLECharacteristic* BLEControl::pDiagCharacteristic = nullptr;
 uint8_t BLEControl::pendingCommand = 0;
 uint8_t BLEControl::commandData[512] = {0};
 size_t BLEControl::commandDataLen = 0;
@@ -44,6 +50,7 @@ void BLEControl::CharacteristicCallbacks::onWrite(NimBLECharacteristic* pChar) {
     Serial.println("⚠️ BLE checksum gagal");
     return;
   }
+  latencyProbe.stamp(LAT_BLE);
 
   BLEControl::pendingCommand = cmd;
   BLEControl::commandDataLen = 1;
@@ -55,6 +62,15 @@ void BLEControl::CharacteristicCallbacks::onWrite(NimBLECharacteristic* pChar) {
 
 BLEControl* BLEControl::instance = nullptr;
 
+// Laporan diisi saat dibaca, jadi selalu terbaru tanpa notify berkala
+void BLEControl::DiagCharacteristicCallbacks::onRead(NimBLECharacteristic* pChar) {
+  String report = latencyProbe.report();
+#if AUDIO_PROFILER
+  report += audioProfiler.report();
+#endif
+  pChar->setValue((uint8_t*)report.c_str(), report.length());
+}
+
 void BLEControl::FileCharacteristicCallbacks::onWrite(NimBLECharacteristic* pChar) {
   if (!BLEControl::instance) {
     Serial.println("⚠️ File callback: instance null!");
@@ -82,6 +98,7 @@ void BLEControl::FileCharacteristicCallbacks::onWrite(NimBLECharacteristic* pCha
 
 void BLEControl::begin() {
     instance = this;
+    if (!normalizeQueue) normalizeQueue = xQueueCreate(BLE_NORMALIZE_QUEUE, BLE_NORMALIZE_PATH_MAX);
     
     // Create audio folders
     // createAudioFolders();
@@ -118,6 +135,13 @@ void BLEControl::begin() {
     );
     // File transfer disabled by default - akan diaktifkan saat programming mode
 
+    // === Characteristic ketiga: diagnostik (read-only) ===
+    pDiagCharacteristic = pService->createCharacteristic(
+        DIAG_CHARACTERISTIC_UUID,
+        NIMBLE_PROPERTY::READ
+    );
+    pDiagCharacteristic->setCallbacks(new DiagCharacteristicCallbacks());
+
     // --- Start service ---
     pService->start();
 
@@ -222,6 +246,16 @@ void BLEControl::endFileTransfer() {
       // Rename temp file to final name
       if (LittleFS.rename(currentFilename, finalFilename)) {
         Serial.printf("✅ File saved: %s (%d bytes)\n", finalFilename.c_str(), receivedBytes);
+        soundCache.invalidate(finalFilename.c_str());
+        // Normalisasi di BLE task (update), bukan di callback NimBLE.
+        // Path disalin ke queue: upload beruntun tidak saling timpa.
+        char queued[BLE_NORMALIZE_PATH_MAX];
+        strncpy(queued, finalFilename.c_str(), sizeof(queued) - 1);
+        queued[sizeof(queued) - 1] = '\0';
+        if (finalFilename.length() >= sizeof(queued) || !normalizeQueue ||
+            xQueueSend(normalizeQueue, queued, 0) != pdTRUE) {
+          Serial.printf("⚠️ Normalisasi %s ditunda ke load pertama\n", finalFilename.c_str());
+        }
       } else {
         Serial.printf("❌ Failed to rename: %s -> %s\n", currentFilename.c_str(), finalFilename.c_str());
       }
@@ -303,7 +337,12 @@ void BLEControl::setActiveFile(uint8_t index) {
 }
 
 void BLEControl::update() {
-  // Reserved for future use
+  // Normalisasi file upload sekali, hasil + flag ditulis balik ke file
+  char path[BLE_NORMALIZE_PATH_MAX];
+  while (normalizeQueue && xQueueReceive(normalizeQueue, path, 0) == pdTRUE) {
+    AudioNormalizer::normalizeFile(path);
+    soundCache.invalidate(path);
+  }
 }
 
 void BLEControl::createAudioFolders() {
@@ -375,6 +414,8 @@ void BLEControl::listAllAudioFiles() {
 void BLEControl::deleteFile(const char* filepath) {
   if (LittleFS.exists(filepath)) {
     if (LittleFS.remove(filepath)) {
+      soundCache.invalidate(filepath);
+      effectMixer.invalidate(filepath);
       Serial.printf("✅ Deleted file: %s\n", filepath);
     } else {
       Serial.printf("❌ Failed to delete file: %s\n", filepath);
@@ -402,6 +443,8 @@ void BLEControl::deleteFolder(const char* folderpath) {
     file = dir.openNextFile();
   }
   dir.close();
+  soundCache.invalidate(folderpath);
+  effectMixer.invalidate(folderpath);
   
   // Delete the folder itself
   if (LittleFS.rmdir(folderpath)) {
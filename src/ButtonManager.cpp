@@ -1,5 +1,6 @@
 #include "ButtonManager.h"
 #include "config.h"
+#include "LatencyProbe.h"
 
 ButtonManager::ButtonManager() {
   flagMutex = portMUX_INITIALIZER_UNLOCKED;
@@ -37,6 +38,7 @@ void ButtonManager::update() {
   // Button A - Simple press
   if (debounceButton(BUTTON_A_PIN, btnA_lastState, btnA_lastChange)) {
     if (btnA_lastState == LOW) {
+      latencyProbe.stamp(LAT_BUTTON);
       portENTER_CRITICAL(&flagMutex);
       btnA_pressed = true;
       portEXIT_CRITICAL(&flagMutex);
@@ -46,6 +48,7 @@ void ButtonManager::update() {
   // Button B - Short and Long press
   if (debounceButton(BUTTON_B_PIN, btnB_lastState, btnB_lastChange)) {
     if (btnB_lastState == LOW) {
+      latencyProbe.stamp(LAT_BUTTON);  // diukur dari tekan, short press baru aktif saat dilepas
       btnB_pressStart = now;
       btnB_longTriggered = false;
     } else {
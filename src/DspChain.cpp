@@ -0,0 +1,191 @@
+#include "DspChain.h"
+
+#define DSP_COMB_FEEDBACK  11469   // 0.35 (Q15)
+#define DSP_COMB_MIX       8192    // 0.25 (Q15)
+#define DSP_COMB_DRY       26214   // 0.8, headroom untuk puncak resonansi
+#define DSP_COMB_MIN_DELAY (16 << 8)
+#define DSP_COMB_SLEW      16      // Q8 per sample (~1/16 sample)
+
+DspChain dspChain;
+
+static inline int16_t IRAM_ATTR clamp16(int32_t v) {
+  if (v > 32767) return 32767;
+  if (v < -32768) return -32768;
+  return (int16_t)v;
+}
+
+static int32_t toCoef(double v) {
+  return (int32_t)lround(v * (double)(1L << DSP_COEF_BITS));
+}
+
+// ===== Biquad =====
+
+BiquadStage::BiquadStage() {
+  memset(coeffs, 0, sizeof(coeffs));
+  coeffs[0].b0 = coeffs[1].b0 = 1L << DSP_COEF_BITS;  // pass-through
+}
+
+void BiquadStage::setCoeffs(const BiquadCoeffs &c) {
+  uint32_t spare = active ^ 1;
+  coeffs[spare] = c;
+  active = spare;
+}
+
+// Akumulator 64-bit (int32 x int32 di Xtensa = 2 instruksi), state 16-bit
+// skala audio, jadi tidak perlu saturasi internal. Sisa pembulatan dibawa
+// ke sample berikutnya (fraction saving): pole high-pass 25Hz dekat 1,
+// tanpa ini error 1/2 LSB dikuatkan ~1/(1+a1+a2) jadi offset DC besar.
+void IRAM_ATTR BiquadStage::process(int16_t *buf, size_t count) {
+  const BiquadCoeffs c = coeffs[active];
+  int32_t sx1 = x1, sx2 = x2, sy1 = y1, sy2 = y2;
+  int64_t rem = residue;
+
+  for (size_t i = 0; i < count; i++) {
+    int32_t x = buf[i];
+    int64_t acc = (int64_t)c.b0 * x + (int64_t)c.b1 * sx1 + (int64_t)c.b2 * sx2 -
+                  (int64_t)c.a1 * sy1 - (int64_t)c.a2 * sy2 + rem;
+    int32_t y = (int32_t)(acc >> DSP_COEF_BITS);
+    rem = acc - ((int64_t)y << DSP_COEF_BITS);
+    sx2 = sx1;
+    sx1 = x;
+    sy2 = sy1;
+    sy1 = y;
+    buf[i] = clamp16(y);
+  }
+
+  x1 = sx1; x2 = sx2; y1 = sy1; y2 = sy2;
+  residue = rem;
+}
+
+BiquadCoeffs BiquadStage::lowPass(float hz, float q) {
+  double w = 2.0 * PI * hz / AUDIO_OUTPUT_RATE;
+  double alpha = sin(w) / (2.0 * q);
+  double cw = cos(w);
+  double a0 = 1.0 + alpha;
+  BiquadCoeffs c;
+  c.b0 = toCoef((1.0 - cw) / 2.0 / a0);
+  c.b1 = toCoef((1.0 - cw) / a0);
+  c.b2 = c.b0;
+  c.a1 = toCoef(-2.0 * cw / a0);
+  c.a2 = toCoef((1.0 - alpha) / a0);
+  return c;
+}
+
+BiquadCoeffs BiquadStage::highPass(float hz, float q) {
+  double w = 2.0 * PI * hz / AUDIO_OUTPUT_RATE;
+  double alpha = sin(w) / (2.0 * q);
+  double cw = cos(w);
+  double a0 = 1.0 + alpha;
+  BiquadCoeffs c;
+  c.b0 = toCoef((1.0 + cw) / 2.0 / a0);
+  c.b1 = toCoef(-(1.0 + cw) / a0);
+  c.b2 = c.b0;
+  c.a1 = toCoef(-2.0 * cw / a0);
+  c.a2 = toCoef((1.0 - alpha) / a0);
+  return c;
+}
+
+// ===== Comb =====
+
+CombStage::CombStage() {
+  memset(line, 0, sizeof(line));
+  delay = targetDelay = DSP_COMB_MIN_DELAY;
+}
+
+void CombStage::setGains(int32_t feedbackQ15, int32_t mixQ15) {
+  feedback = feedbackQ15;
+  mix = mixQ15;
+}
+
+// y = dry * x + mix * d, line = x + feedback * d, d = line[n - delay]
+void IRAM_ATTR CombStage::process(int16_t *buf, size_t count) {
+  const uint32_t MASK = AUDIO_DSP_COMB_MAX - 1;
+  uint32_t target = targetDelay;
+  uint32_t cur = delay;
+  uint32_t w = writePos;
+
+  for (size_t i = 0; i < count; i++) {
+    if (cur < target) cur = (target - cur > DSP_COMB_SLEW) ? cur + DSP_COMB_SLEW : target;
+    else if (cur > target) cur = (cur - target > DSP_COMB_SLEW) ? cur - DSP_COMB_SLEW : target;
+
+    uint32_t r = w - (cur >> 8);
+    int32_t d0 = line[r & MASK];
+    int32_t d1 = line[(r - 1) & MASK];
+    int32_t d = d0 + (((d1 - d0) * (int32_t)(cur & 0xFF)) >> 8);
+
+    int32_t x = buf[i];
+    line[w & MASK] = clamp16(x + ((d * feedback) >> 15));
+    buf[i] = clamp16((x * DSP_COMB_DRY + d * mix) >> 15);
+    w++;
+  }
+
+  delay = cur;
+  writePos = w;
+}
+
+// ===== Chain =====
+
+DspChain::DspChain() {
+  memset(stages, 0, sizeof(stages));
+}
+
+// Tabel koefisien dihitung sekali di sini (float), render hanya integer
+void DspChain::begin() {
+  for (uint8_t i = 0; i < AUDIO_DSP_LP_STEPS; i++) {
+    // Cutoff logaritmik min -> max
+    float t = (float)i / (AUDIO_DSP_LP_STEPS - 1);
+    float hz = AUDIO_DSP_LP_MIN_HZ * powf((float)AUDIO_DSP_LP_MAX_HZ / AUDIO_DSP_LP_MIN_HZ, t);
+    lowPassTable[i] = BiquadStage::lowPass(hz, 0.707f);
+  }
+
+  // Delay comb = satu periode firing; kalau lebih panjang dari delay line,
+  // pakai harmonik (periode / 2, / 4, ...) yang masih muat
+  for (uint8_t i = 0; i < AUDIO_DSP_COMB_STEPS; i++) {
+    uint32_t rpm = (uint32_t)(i + 1) * AUDIO_DSP_COMB_MAX_RPM / AUDIO_DSP_COMB_STEPS;
+    uint64_t d = ((uint64_t)AUDIO_OUTPUT_RATE * 120 << 8) / ((uint64_t)rpm * AUDIO_DSP_COMB_CYL);
+    while (d > (uint64_t)(AUDIO_DSP_COMB_MAX - 2) << 8) d >>= 1;
+    if (d < DSP_COMB_MIN_DELAY) d = DSP_COMB_MIN_DELAY;
+    combDelayTable[i] = (uint32_t)d;
+  }
+
+  dcBlock.setCoeffs(BiquadStage::highPass(AUDIO_DSP_HP_HZ, 0.707f));
+  exhaust.setGains(DSP_COMB_FEEDBACK, DSP_COMB_MIX);
+  setLoad(255);
+  setRPM(0);
+
+  stageCount = 0;
+  add(&dcBlock);
+  add(&throttleLowPass);
+  add(&exhaust);
+  Serial.printf("✅ DSP chain: %d stage (%s)\n", stageCount, enabled ? "ON" : "OFF");
+}
+
+// Tambah stage di akhir rantai. Pointer ditulis sebelum count dinaikkan,
+// jadi render tidak pernah melihat slot kosong.
+bool DspChain::add(DspStage *stage) {
+  if (!stage || stageCount >= AUDIO_DSP_MAX_STAGES) return false;
+  stages[stageCount] = stage;
+  stageCount = stageCount + 1;
+  return true;
+}
+
+void DspChain::setLoad(uint8_t load) {
+  uint8_t step = (uint8_t)(((uint32_t)load * AUDIO_DSP_LP_STEPS) >> 8);
+  if (step == loadStep) return;
+  loadStep = step;
+  throttleLowPass.setCoeffs(lowPassTable[step]);
+}
+
+void DspChain::setRPM(uint32_t rpm) {
+  uint32_t step = (uint32_t)(((uint64_t)rpm * AUDIO_DSP_COMB_STEPS) / AUDIO_DSP_COMB_MAX_RPM);
+  if (step >= AUDIO_DSP_COMB_STEPS) step = AUDIO_DSP_COMB_STEPS - 1;
+  if (step == rpmStep) return;
+  rpmStep = (uint8_t)step;
+  exhaust.setDelay(combDelayTable[step]);
+}
+
+void IRAM_ATTR DspChain::process(int16_t *buf, size_t count) {
+  if (!enabled) return;
+  uint8_t n = stageCount;
+  for (uint8_t i = 0; i < n; i++) stages[i]->process(buf, count);
+}
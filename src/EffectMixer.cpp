@@ -0,0 +1,240 @@
+#include "EffectMixer.h"
+#include <LittleFS.h>
+#include "AudioSink.h"
+#include "AudioMeta.h"
+#include "ImaAdpcm.h"
+
+EffectMixer effectMixer;
+
+// Mapping folder/prefix nama file -> jenis efek
+static const char *const shiftPrefixes[] = {"up", "down"};
+static const EffectId shiftIds[] = {EFFECT_SHIFT_UP, EFFECT_SHIFT_DOWN};
+static const char *const effectPrefixes[] = {"pop", "start", "stop"};
+static const EffectId effectIds[] = {EFFECT_POP, EFFECT_START, EFFECT_STOP};
+
+EffectMixer::EffectMixer() {
+  memset(samples, 0, sizeof(samples));
+  memset(nextVariant, 0, sizeof(nextVariant));
+  memset(voices, 0, sizeof(voices));
+}
+
+// Pool dialokasi sekali di sini dan tidak pernah di-free/realloc
+void EffectMixer::begin(AudioSink *outputSink) {
+  sink = outputSink;
+  if (pool) return;
+
+  bool usePSRAM = psramFound();
+  poolSize = usePSRAM ? AUDIO_EFFECT_POOL_PSRAM : AUDIO_EFFECT_POOL_RAM;
+  pool = (uint8_t *)(usePSRAM ? ps_malloc(poolSize) : malloc(poolSize));
+  if (!pool) {
+    poolSize = 0;
+    Serial.println("❌ Pool efek gagal dialokasi");
+    return;
+  }
+  Serial.printf("✅ Effect pool: %lu KB (%s)\n", poolSize / 1024, usePSRAM ? "PSRAM" : "RAM");
+}
+
+// Baca ulang semua rekaman efek ke pool. Sink di-pause selama load
+// supaya render tidak membaca pool yang sedang ditimpa (hanya saat boot
+// dan setelah file efek dihapus).
+void EffectMixer::load() {
+  if (!pool) return;
+
+  if (sink) sink->pause();
+  memset(voices, 0, sizeof(voices));
+  activeVoices = 0;
+  portENTER_CRITICAL(&queueMux);
+  queueTail = queueHead;
+  portEXIT_CRITICAL(&queueMux);
+  sampleCount = 0;
+  poolUsed = 0;
+  memset(nextVariant, 0, sizeof(nextVariant));
+
+  loadFolder("/audio/shift", shiftPrefixes, shiftIds, 2);
+  loadFolder("/audio/effects", effectPrefixes, effectIds, 3);
+  if (sink) sink->resume();
+
+  Serial.printf("✅ Effects: %d sample, %lu/%lu bytes\n", sampleCount, poolUsed, poolSize);
+}
+
+// File di folder efek berubah: load ulang pool
+void EffectMixer::invalidate(const char *path) {
+  String p = path;
+  if (p.startsWith("/audio/shift") || p.startsWith("/audio/effects")) {
+    load();
+  }
+}
+
+void EffectMixer::loadFolder(const char *folder, const char *const *prefixes,
+                             const EffectId *ids, uint8_t kinds) {
+  File dir = LittleFS.open(folder);
+  if (!dir || !dir.isDirectory()) return;
+
+  File file = dir.openNextFile();
+  while (file && sampleCount < AUDIO_EFFECT_MAX_SAMPLES) {
+    String name = file.name();
+    bool isRaw = !file.isDirectory() && name.endsWith(".raw");
+    file.close();
+
+    if (isRaw) {
+      for (uint8_t k = 0; k < kinds; k++) {
+        if (name.startsWith(prefixes[k])) {
+          loadSample((String(folder) + "/" + name).c_str(), ids[k]);
+          break;
+        }
+      }
+    }
+    file = dir.openNextFile();
+  }
+  dir.close();
+}
+
+bool EffectMixer::loadSample(const char *path, EffectId id) {
+  AudioMeta meta;
+  if (!audioMeta.load(path, meta) || meta.sampleCount < 2) return false;
+
+  if (poolUsed + meta.sampleCount > poolSize) {
+    Serial.printf("⚠️ Pool efek penuh, skip %s\n", path);
+    return false;
+  }
+
+  File f = LittleFS.open(path, "r");
+  if (!f) {
+    Serial.printf("❌ Gagal buka %s\n", path);
+    return false;
+  }
+  f.seek(meta.dataOffset);
+  uint8_t *dst = pool + poolUsed;
+  bool ok = readSample(f, meta, dst);
+  f.close();
+  if (!ok) return false;
+
+  EffectSample &s = samples[sampleCount];
+  s.id = id;
+  s.data = dst;
+  s.length = meta.sampleCount;
+  uint32_t rate = meta.sample_rate ? meta.sample_rate : AUDIO_OUTPUT_RATE;
+  s.phaseInc = (uint32_t)(((uint64_t)rate << AUDIO_PHASE_BITS) / AUDIO_OUTPUT_RATE);
+
+  poolUsed += meta.sampleCount;
+  sampleCount++;
+  Serial.printf("✅ Effect: %s (%lu sample)\n", path, meta.sampleCount);
+  return true;
+}
+
+// PCM 8-bit dibaca langsung, ADPCM di-decode blok demi blok ke pool
+bool EffectMixer::readSample(File &f, const AudioMeta &meta, uint8_t *dst) {
+  if (meta.format != AUDIO_FORMAT_ADPCM) {
+    return f.read(dst, meta.dataLength) == meta.dataLength;
+  }
+
+  static uint8_t block[AUDIO_ADPCM_MAX_BLOCK];
+  uint32_t blocks = meta.dataLength / meta.blockBytes;
+  for (uint32_t b = 0; b < blocks; b++) {
+    if (f.read(block, meta.blockBytes) != meta.blockBytes) return false;
+    dst += ImaAdpcm::decodeBlock(block, meta.blockBytes, dst);
+  }
+  return true;
+}
+
+bool EffectMixer::hasEffect(EffectId id) {
+  for (uint8_t i = 0; i < sampleCount; i++) {
+    if (samples[i].id == id) return true;
+  }
+  return false;
+}
+
+// Pilih varian berikutnya lalu antrikan; voice baru dimulai render di
+// blok berikutnya. Return false kalau efek tidak punya rekaman atau
+// antrian penuh.
+bool EffectMixer::trigger(EffectId id, uint8_t gain) {
+  if (id >= EFFECT_COUNT || gain == 0) return false;
+
+  uint8_t matches[AUDIO_EFFECT_MAX_SAMPLES];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < sampleCount; i++) {
+    if (samples[i].id == id) matches[n++] = i;
+  }
+  if (n == 0) return false;
+
+  bool queued = false;
+  portENTER_CRITICAL(&queueMux);
+  uint8_t pick = matches[nextVariant[id] % n];
+  nextVariant[id]++;
+  if (queueHead - queueTail < AUDIO_EFFECT_QUEUE) {
+    EffectTrigger &t = queue[queueHead & (AUDIO_EFFECT_QUEUE - 1)];
+    t.sample = pick;
+    t.gain = gain;
+    queueHead++;
+    queued = true;
+  }
+  portEXIT_CRITICAL(&queueMux);
+  return queued;
+}
+
+// Ambil trigger dari antrian ke voice bebas, atau curi voice tertua
+void IRAM_ATTR EffectMixer::startQueued() {
+  while (queueTail != queueHead) {
+    portENTER_CRITICAL(&queueMux);
+    EffectTrigger t = queue[queueTail & (AUDIO_EFFECT_QUEUE - 1)];
+    queueTail++;
+    portEXIT_CRITICAL(&queueMux);
+
+    EffectVoice *voice = &voices[0];
+    for (uint8_t v = 0; v < AUDIO_EFFECT_VOICES; v++) {
+      if (!voices[v].sample) { voice = &voices[v]; break; }
+      if (voices[v].started < voice->started) voice = &voices[v];
+    }
+
+    voice->sample = &samples[t.sample];
+    voice->pos = 0;
+    voice->frac = 0;
+    voice->gain = ((int32_t)t.gain * 32768) / 255;
+    voice->started = ++triggerCounter;
+  }
+}
+
+// Interpolasi linear per voice ke 16-bit, dijumlahkan ke bus dengan
+// saturasi. Voice selesai di akhir rekaman (tanpa loop).
+void IRAM_ATTR EffectMixer::render(int16_t *bus, size_t count) {
+  startQueued();
+
+  uint8_t active = 0;
+  for (uint8_t v = 0; v < AUDIO_EFFECT_VOICES; v++) {
+    EffectVoice &voice = voices[v];
+    const EffectSample *s = voice.sample;
+    if (!s) continue;
+
+    const uint8_t *data = s->data;
+    uint32_t last = s->length - 1;
+    uint32_t inc = s->phaseInc;
+    uint32_t pos = voice.pos;
+    uint32_t frac = voice.frac;
+    int32_t gain = voice.gain;
+
+    size_t i = 0;
+    for (; i < count && pos < last; i++) {
+      int32_t s0 = (int32_t)data[pos] - 128;
+      int32_t s1 = (int32_t)data[pos + 1] - 128;
+      int32_t x = s0 * 256 + (s1 - s0) * (int32_t)(frac >> (AUDIO_PHASE_BITS - 8));
+
+      int32_t y = bus[i] + ((x * gain) >> 15);
+      if (y < -32768) y = -32768;
+      if (y > 32767) y = 32767;
+      bus[i] = (int16_t)y;
+
+      uint32_t acc = frac + inc;
+      pos += acc >> AUDIO_PHASE_BITS;
+      frac = acc & ((1UL << AUDIO_PHASE_BITS) - 1);
+    }
+
+    if (pos >= last) {
+      voice.sample = nullptr;
+    } else {
+      voice.pos = pos;
+      voice.frac = frac;
+      active++;
+    }
+  }
+  activeVoices = active;
+}
@@ -0,0 +1,380 @@
+#include "EngineSoundBank.h"
+#include "AudioMeta.h"
+
+#define BANK_UNITY    32768   // bobot Q15 = 1.0
+#define BANK_FADE_STEP (BANK_UNITY / AUDIO_BANK_FADE_SAMPLES)
+
+#define GRAIN_END     ((uint32_t)AUDIO_GRAIN_WINDOW << AUDIO_PHASE_BITS)
+
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
+
+// Scratch mix buffer (satu konteks render pada satu waktu)
+static int32_t mixBuf[AUDIO_BLOCK_SAMPLES];
+
+// Jendela Hann periodik Q15 untuk grain: dua jendela yang bergeser
+// setengah panjang berjumlah tepat 1.0, jadi overlap-add tidak bergelombang
+static DRAM_ATTR uint16_t grainWindow[AUDIO_GRAIN_WINDOW];
+static bool grainWindowReady = false;
+
+static void buildGrainWindow() {
+  for (uint32_t k = 0; k < AUDIO_GRAIN_WINDOW; k++) {
+    float w = 0.5f - 0.5f * cosf(2.0f * (float)PI * k / AUDIO_GRAIN_WINDOW);
+    grainWindow[k] = (uint16_t)(w * BANK_UNITY + 0.5f);
+  }
+  grainWindowReady = true;
+}
+
+EngineSoundBank::EngineSoundBank() {
+  memset(cells, 0, sizeof(cells));
+  envelopes.mask = 0;
+  VehicleModel::defaultParams(vehicle);
+  shifts.mask = 0;
+  if (!grainWindowReady) buildGrainWindow();
+}
+
+// Tambah rekaman ke bank. Bank ambil alih ownership `data` (di-free saat clear).
+bool EngineSoundBank::addCell(uint8_t *data, uint32_t length, const AudioMeta &meta) {
+  if (cellCount >= AUDIO_BANK_MAX_CELLS) {
+    Serial.printf("⚠️ Bank penuh (%d cell)\n", AUDIO_BANK_MAX_CELLS);
+    return false;
+  }
+  if (!data || length < 2 || meta.sample_engine_rpm == 0 || meta.sample_rate == 0) {
+    return false;
+  }
+
+  SoundCell &cell = cells[cellCount];
+  memset(&cell, 0, sizeof(cell));
+  cell.data = data;
+  cell.length = length;
+  cell.loopStart = 0;
+  cell.loopEnd = length;
+  if (meta.loopEnd > 0 && meta.loopEnd <= length && meta.loopStart < meta.loopEnd) {
+    cell.loopStart = meta.loopStart;
+    cell.loopEnd = meta.loopEnd;
+  }
+  cell.refRPM = meta.sample_engine_rpm;
+  cell.sampleRate = meta.sample_rate;
+  cell.load = meta.load ? 1 : 0;
+
+  // Panjang siklus pembakaran (cycleRevs putaran) di refRPM. Satu grain
+  // memuat satu siklus penuh, jadi urutan firing (termasuk interval tidak
+  // rata, mis. V-twin) tetap utuh di dalam grain.
+  uint64_t cycleSec = 60ULL * meta.cycleRevs;
+  cell.cycleRevs = meta.cycleRevs;
+  cell.cycleLen = (uint32_t)((cycleSec * meta.sample_rate << AUDIO_PHASE_BITS) / meta.sample_engine_rpm);
+  cell.cycleOut = (uint32_t)(cycleSec * AUDIO_OUTPUT_RATE / meta.sample_engine_rpm);
+  cell.grainInc = (uint32_t)(((uint64_t)meta.sample_rate << AUDIO_PHASE_BITS) / AUDIO_OUTPUT_RATE);
+  cell.mark = cell.loopStart;
+  cell.grains[0].phase = GRAIN_END;
+  cell.grains[1].phase = GRAIN_END;
+  cell.granular = meta.granular;
+  if (cell.granular && (cell.cycleOut < 2 || (cell.cycleLen >> AUDIO_PHASE_BITS) * 2 > cell.loopEnd - cell.loopStart)) {
+    Serial.println("⚠️ Rekaman < 2 siklus, mode granular dimatikan");
+    cell.granular = false;
+  }
+  if (cell.granular) {
+    // Pitch mark = puncak amplitudo di siklus pertama (biasanya pulsa
+    // firing), grain dipusatkan di sini supaya pulsa ada di puncak jendela
+    uint32_t end = cell.loopStart + (cell.cycleLen >> AUDIO_PHASE_BITS);
+    int32_t peak = -1;
+    for (uint32_t i = cell.loopStart; i < end; i++) {
+      int32_t a = (int32_t)data[i] - 128;
+      if (a < 0) a = -a;
+      if (a > peak) { peak = a; cell.mark = i; }
+    }
+  }
+  if (cellCount == 0) {
+    vehicle = meta.vehicle;
+    shifts = meta.shifts;
+  }
+  cellCount++;
+
+  for (uint8_t i = 0; i < ENV_CURVE_COUNT; i++) {
+    if ((meta.envelopes.mask & (1 << i)) && !(envelopes.mask & (1 << i))) {
+      envelopes.curves[i] = meta.envelopes.curves[i];
+      envelopes.mask |= 1 << i;
+    }
+  }
+
+  // Cell baru langsung pakai bobot target, tanpa fade-in dari nol
+  updateTargets();
+  cell.weight = cell.targetWeight;
+  return true;
+}
+
+// Free semua rekaman. Output sink harus di-pause dulu oleh pemanggil.
+void EngineSoundBank::clear() {
+  uint8_t n = cellCount;
+  cellCount = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    if (cells[i].data) free(cells[i].data);
+  }
+  memset(cells, 0, sizeof(cells));
+  envelopes.mask = 0;
+  VehicleModel::defaultParams(vehicle);
+  shifts.mask = 0;
+}
+
+uint32_t EngineSoundBank::getTotalBytes() {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < cellCount; i++) total += cells[i].length;
+  return total;
+}
+
+uint8_t EngineSoundBank::getActiveVoices() {
+  uint8_t active = 0;
+  for (uint8_t i = 0; i < cellCount; i++) {
+    if (cells[i].weight != 0 || cells[i].targetWeight != 0) active++;
+  }
+  return active;
+}
+
+void EngineSoundBank::setRPM(uint32_t rpm) {
+  if (rpm == targetRPM) return;
+  targetRPM = rpm;
+  updateTargets();
+}
+
+void EngineSoundBank::setLoad(uint8_t load) {
+  if (load == targetLoad) return;
+  targetLoad = load;
+  updateTargets();
+}
+
+// Konversi "sample rate" lama (8k-44.1k) ke RPM memakai rekaman primary
+// (refRPM terendah). Untuk bank 1 cell hasilnya identik dengan playback lama:
+// rekaman diputar tepat pada `rate` sample/detik.
+uint32_t EngineSoundBank::rateToRPM(uint32_t rate) {
+  const SoundCell *primary = nullptr;
+  for (uint8_t i = 0; i < cellCount; i++) {
+    if (!primary || cells[i].refRPM < primary->refRPM) primary = &cells[i];
+  }
+  if (!primary) return 0;
+  return (uint32_t)(((uint64_t)rate * primary->refRPM) / primary->sampleRate);
+}
+
+// Pilih dua rekaman terdekat (bawah/atas RPM) di satu layer load dan isi
+// bobot Q15 linear. Layer tanpa rekaman dibiarkan nol.
+void EngineSoundBank::selectLayer(uint8_t load, uint32_t rpm, int32_t *weights) {
+  int8_t lo = -1;
+  int8_t hi = -1;
+
+  for (uint8_t i = 0; i < cellCount; i++) {
+    if (cells[i].load != load) continue;
+    uint32_t ref = cells[i].refRPM;
+    if (ref <= rpm) {
+      if (lo < 0 || ref > cells[lo].refRPM) lo = i;
+    } else {
+      if (hi < 0 || ref < cells[hi].refRPM) hi = i;
+    }
+  }
+
+  if (lo < 0 && hi < 0) return;
+  if (lo < 0) { weights[hi] = BANK_UNITY; return; }
+  if (hi < 0) { weights[lo] = BANK_UNITY; return; }
+
+  uint32_t span = cells[hi].refRPM - cells[lo].refRPM;
+  int32_t t = (int32_t)(((uint64_t)(rpm - cells[lo].refRPM) * BANK_UNITY) / span);
+  weights[hi] = t;
+  weights[lo] = BANK_UNITY - t;
+}
+
+// Hitung ulang phase increment dan bobot target semua cell (control rate)
+void EngineSoundBank::updateTargets() {
+  int32_t onWeights[AUDIO_BANK_MAX_CELLS] = {0};
+  int32_t offWeights[AUDIO_BANK_MAX_CELLS] = {0};
+  bool hasOn = false;
+  bool hasOff = false;
+
+  for (uint8_t i = 0; i < cellCount; i++) {
+    if (cells[i].load) hasOn = true; else hasOff = true;
+  }
+  selectLayer(1, targetRPM, onWeights);
+  selectLayer(0, targetRPM, offWeights);
+
+  // Crossfade antar layer sesuai load; layer yang kosong diwakili layer lain
+  int32_t onGain = hasOff ? ((int32_t)targetLoad * BANK_UNITY + 127) / 255 : BANK_UNITY;
+  if (!hasOn) onGain = 0;
+  int32_t offGain = BANK_UNITY - onGain;
+
+  for (uint8_t i = 0; i < cellCount; i++) {
+    SoundCell &cell = cells[i];
+
+    uint64_t inc = ((uint64_t)targetRPM * cell.sampleRate << AUDIO_PHASE_BITS) /
+                   ((uint64_t)cell.refRPM * AUDIO_OUTPUT_RATE);
+    if (inc > AUDIO_BANK_MAX_STEP) inc = AUDIO_BANK_MAX_STEP;
+    cell.phaseInc = (uint32_t)inc;
+
+    // Jarak antar grain = satu siklus pada RPM target
+    uint64_t hop = targetRPM ? ((60ULL * cell.cycleRevs * AUDIO_OUTPUT_RATE) << AUDIO_PHASE_BITS) / targetRPM
+                             : (uint64_t)cell.cycleOut << AUDIO_PHASE_BITS;
+    if (hop > 0x7FFF0000ULL) hop = 0x7FFF0000ULL;
+    cell.grainHop = (uint32_t)hop;
+
+    cell.targetWeight = (int32_t)(((int64_t)onWeights[i] * onGain +
+                                   (int64_t)offWeights[i] * offGain) >> 15);
+  }
+}
+
+// Mix semua cell yang bobotnya tidak nol. Loop per cell lalu per sample
+// supaya state cell tetap di register; bobot di-slew per sample ke target
+// (BANK_FADE_STEP) jadi perpindahan cell tidak klik. Output ke bus mix
+// 16-bit signed; kuantisasi ke DAC 8-bit baru di tahap volume.
+void IRAM_ATTR EngineSoundBank::render(int16_t *out, size_t count) {
+  uint8_t n = cellCount;
+  if (n == 0) {
+    memset(out, 0, count * sizeof(int16_t));
+    return;
+  }
+
+  while (count > 0) {
+    size_t len = (count < AUDIO_BLOCK_SAMPLES) ? count : AUDIO_BLOCK_SAMPLES;
+    memset(mixBuf, 0, len * sizeof(int32_t));
+
+    for (uint8_t c = 0; c < n; c++) {
+      SoundCell &cell = cells[c];
+      int32_t target = cell.targetWeight;
+      int32_t w = cell.weight;
+      if (w == 0 && target == 0) continue;
+      if (cell.granular) {
+        renderGranular(cell, len);
+        continue;
+      }
+
+      const uint8_t *data = cell.data;
+      uint32_t loopStart = cell.loopStart;
+      uint32_t loopEnd = cell.loopEnd;
+      uint32_t loopLen = loopEnd - loopStart;
+      uint32_t pos = cell.pos;
+      uint32_t frac = cell.frac;
+      uint32_t inc = cell.phaseInc;
+
+      for (size_t i = 0; i < len; i++) {
+        int32_t d = target - w;
+        if (d > BANK_FADE_STEP) d = BANK_FADE_STEP;
+        else if (d < -BANK_FADE_STEP) d = -BANK_FADE_STEP;
+        w += d;
+
+        uint32_t next = pos + 1;
+        if (next >= loopEnd) next = loopStart;
+
+        // Linear interpolation ke 16-bit (bobot 8 bit dari fraksi phase
+        // jadi bit bawah hasil), sample centered di 0
+        int32_t s0 = (int32_t)data[pos] - 128;
+        int32_t s1 = (int32_t)data[next] - 128;
+        int32_t s = s0 * 256 + (s1 - s0) * (int32_t)(frac >> (AUDIO_PHASE_BITS - 8));
+        mixBuf[i] += (s * w) >> 15;
+
+        uint32_t acc = frac + inc;
+        pos += acc >> AUDIO_PHASE_BITS;
+        while (pos >= loopEnd) pos -= loopLen;
+        frac = acc & ((1UL << AUDIO_PHASE_BITS) - 1);
+      }
+
+      cell.pos = pos;
+      cell.frac = frac;
+      cell.weight = w;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+      int32_t v = mixBuf[i];
+      if (v < -32768) v = -32768;
+      if (v > 32767) v = 32767;
+      out[i] = (int16_t)v;
+    }
+
+    out += len;
+    count -= len;
+  }
+}
+
+// Satu sample 16-bit dari grain (sudah dikali jendela), lalu maju satu
+// sample output dengan pitch asli rekaman
+static inline int32_t IRAM_ATTR grainSample(GrainVoice &g, const uint8_t *data,
+                                            uint32_t loopStart, uint32_t loopEnd, uint32_t inc) {
+  uint32_t pos = g.pos;
+  uint32_t next = pos + 1;
+  if (next >= loopEnd) next = loopStart;
+
+  int32_t s0 = (int32_t)data[pos] - 128;
+  int32_t s1 = (int32_t)data[next] - 128;
+  int32_t s = s0 * 256 + (s1 - s0) * (int32_t)(g.frac >> (AUDIO_PHASE_BITS - 8));
+  int32_t y = (s * (int32_t)grainWindow[g.phase >> AUDIO_PHASE_BITS]) >> 15;
+
+  uint32_t acc = g.frac + inc;
+  pos += acc >> AUDIO_PHASE_BITS;
+  while (pos >= loopEnd) pos -= loopEnd - loopStart;
+  g.pos = pos;
+  g.frac = acc & ((1UL << AUDIO_PHASE_BITS) - 1);
+  g.phase += g.phaseStep;
+  return y;
+}
+
+// Overlap-add grain satu siklus: grain baru mulai tiap grainHop sample
+// output dari siklus rekaman berikutnya (mark maju satu siklus), dengan
+// puncak jendela tepat di mark. Panjang
+// jendela 2x siklus terpendek (rekaman vs target), jadi paling banyak dua
+// grain bertumpuk. Semua integer + tabel; satu pembagian per grain.
+void IRAM_ATTR EngineSoundBank::renderGranular(SoundCell &cell, size_t len) {
+  const uint32_t ONE = 1UL << AUDIO_PHASE_BITS;
+  const uint8_t *data = cell.data;
+  uint32_t loopStart = cell.loopStart;
+  uint32_t loopEnd = cell.loopEnd;
+  uint32_t loopLen = loopEnd - loopStart;
+  uint32_t inc = cell.grainInc;
+  uint32_t hop = cell.grainHop;
+  int32_t until = cell.untilOnset;
+  int32_t target = cell.targetWeight;
+  int32_t w = cell.weight;
+  GrainVoice &g0 = cell.grains[0];
+  GrainVoice &g1 = cell.grains[1];
+
+  // RPM naik tajam: jangan tunggu sisa jarak grain lama
+  if (until > (int32_t)hop) until = (int32_t)hop;
+
+  for (size_t i = 0; i < len; i++) {
+    int32_t d = target - w;
+    if (d > BANK_FADE_STEP) d = BANK_FADE_STEP;
+    else if (d < -BANK_FADE_STEP) d = -BANK_FADE_STEP;
+    w += d;
+
+    if (until <= 0) {
+      // Slot bebas, atau grain yang paling dekat selesai
+      GrainVoice &g = (g0.phase >= GRAIN_END || (g1.phase < GRAIN_END && g0.phase > g1.phase)) ? g0 : g1;
+      uint32_t hopOut = hop >> AUDIO_PHASE_BITS;
+      uint32_t grainLen = 2 * (hopOut < cell.cycleOut ? hopOut : cell.cycleOut);
+      if (grainLen < 2) grainLen = 2;
+
+      // Grain mulai setengah jendela sebelum mark (di domain sumber)
+      uint32_t back = (grainLen / 2) * inc;
+      uint32_t startPos = cell.mark - (back >> AUDIO_PHASE_BITS);
+      int32_t startFrac = (int32_t)cell.markFrac - (int32_t)(back & (ONE - 1));
+      if (startFrac < 0) { startFrac += ONE; startPos--; }
+      while ((int32_t)(startPos - loopStart) < 0) startPos += loopLen;
+
+      g.pos = startPos;
+      g.frac = (uint32_t)startFrac;
+      g.phase = 0;
+      g.phaseStep = GRAIN_END / grainLen;
+
+      uint32_t acc = (cell.cycleLen & (ONE - 1)) + cell.markFrac;
+      cell.mark += (cell.cycleLen >> AUDIO_PHASE_BITS) + (acc >> AUDIO_PHASE_BITS);
+      cell.markFrac = acc & (ONE - 1);
+      while (cell.mark >= loopEnd) cell.mark -= loopLen;
+      until += (int32_t)hop;
+    }
+    until -= (int32_t)ONE;
+
+    int32_t sum = 0;
+    if (g0.phase < GRAIN_END) sum += grainSample(g0, data, loopStart, loopEnd, inc);
+    if (g1.phase < GRAIN_END) sum += grainSample(g1, data, loopStart, loopEnd, inc);
+    if (sum > 32767) sum = 32767;
+    else if (sum < -32768) sum = -32768;
+    mixBuf[i] += (sum * w) >> 15;
+  }
+
+  cell.untilOnset = until;
+  cell.weight = w;
+}
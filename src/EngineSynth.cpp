@@ -0,0 +1,141 @@
+#include "EngineSynth.h"
+
+#define SYNTH_UNITY      32768
+#define SYNTH_PULSE_AMP  12000   // tinggi pulsa firing sebelum resonator
+#define SYNTH_DECAY_SHIFT 6      // decay pulsa ~64 sample (~1.6ms)
+#define SYNTH_DC_POLE    32604   // DC blocker R = 0.995 (Q15)
+#define SYNTH_FADE_STEP  (SYNTH_UNITY / AUDIO_SWAP_FADE_SAMPLES)
+
+EngineSynth engineSynth;
+
+// Preset bawaan, satu per register kosong (index = nomor register - 1)
+static const SynthPreset synthPresets[] = {
+  // name            cyl  firing (derajat)                          idle  redline exh  damp noise
+  {"Inline-4",        4, {0, 180, 360, 540},                         800,  9000,  180,  70,  60},
+  {"V-twin 90",       2, {0, 270},                                  1000,  8000,  110,  55,  90},
+  {"V8",             8, {0, 90, 180, 270, 360, 450, 540, 630},      700,  7000,  140,  60,  50},
+  {"Single",          1, {0},                                       1200, 10000,  220,  50, 110},
+};
+
+EngineSynth::EngineSynth() {
+  setPreset(0);
+}
+
+uint8_t EngineSynth::getPresetCount() {
+  return sizeof(synthPresets) / sizeof(synthPresets[0]);
+}
+
+// Hitung tabel firing + koefisien resonator. Pemanggil memastikan render
+// tidak sedang jalan (sink di-pause atau synth belum aktif).
+void EngineSynth::setPreset(uint8_t index) {
+  if (index >= getPresetCount()) index = 0;
+  preset = &synthPresets[index];
+
+  cylinders = preset->cylinders;
+  if (cylinders == 0) cylinders = 1;
+  if (cylinders > AUDIO_SYNTH_MAX_CYL) cylinders = AUDIO_SYNTH_MAX_CYL;
+
+  // Sudut firing ke fase 32-bit, diurutkan (insertion sort, maks 8).
+  // Tiap silinder sedikit beda amplitudo supaya tidak terdengar seperti
+  // buzzer: pola tetap per silinder, bukan acak per siklus.
+  for (uint8_t k = 0; k < cylinders; k++) {
+    uint32_t at = (uint32_t)(((uint64_t)(preset->firing[k] % 720) << 32) / 720);
+    int32_t gain = SYNTH_UNITY - (int32_t)((k * 5) % 7) * 1200;
+    int8_t j = k - 1;
+    while (j >= 0 && fireAt[j] > at) {
+      fireAt[j + 1] = fireAt[j];
+      cylGain[j + 1] = cylGain[j];
+      j--;
+    }
+    fireAt[j + 1] = at;
+    cylGain[j + 1] = gain;
+  }
+
+  svfF = (int32_t)(2.0f * sinf((float)PI * preset->exhaustHz / AUDIO_OUTPUT_RATE) * SYNTH_UNITY);
+  svfDamp = preset->damping ? preset->damping : 1;
+  noiseMix = preset->noise;
+
+  phase = 0;
+  nextCyl = 0;
+  env = 0;
+  low = 0;
+  band = 0;
+  dcIn = 0;
+  dcOut = 0;
+  level = 0;   // fade in dari diam
+  setRPM(preset->idleRPM);
+}
+
+// RPM -> increment fase siklus (satu siklus 4-tak = 2 putaran)
+void EngineSynth::setRPM(uint32_t value) {
+  if (value < preset->idleRPM / 2) value = preset->idleRPM / 2;
+  rpm = value;
+  phaseInc = (uint32_t)(((uint64_t)value << 32) / (120ULL * AUDIO_OUTPUT_RATE));
+}
+
+// On-throttle: pulsa lebih keras (55% saat decel, 100% full load)
+void EngineSynth::setLoad(uint8_t load) {
+  loadGain = (SYNTH_UNITY * 55 + (int32_t)load * SYNTH_UNITY * 45 / 255) / 100;
+}
+
+// Skala sample rate lama (8k-44.1k) ke rentang idle-redline preset
+uint32_t EngineSynth::rateToRPM(uint32_t rate) {
+  if (rate < 8000) rate = 8000;
+  if (rate > 44100) rate = 44100;
+  return preset->idleRPM + (uint32_t)((uint64_t)(rate - 8000) *
+                                      (preset->redlineRPM - preset->idleRPM) / (44100 - 8000));
+}
+
+void IRAM_ATTR EngineSynth::render(int16_t *out, size_t count) {
+  uint32_t inc = phaseInc;
+  int32_t pulse = (SYNTH_PULSE_AMP * loadGain) >> 15;
+  uint32_t ph = phase;
+  uint8_t next = nextCyl;
+  int32_t e = env;
+  int32_t lo = low;
+  int32_t bp = band;
+  uint32_t seed = noiseSeed;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t prev = ph;
+    ph += inc;
+
+    // Silinder berikutnya firing kalau sudutnya dilewati sample ini
+    uint32_t at = fireAt[next];
+    if ((uint32_t)(at - prev) < inc) {
+      e += (pulse * cylGain[next]) >> 15;
+      if (e > SYNTH_UNITY) e = SYNTH_UNITY;
+      next = (next + 1 < cylinders) ? next + 1 : 0;
+    }
+
+    // Pulsa decay + noise pembakaran yang ikut envelope pulsa
+    seed = seed * 1664525u + 1013904223u;
+    int32_t noise = (int32_t)(seed >> 16) - 32768;
+    int32_t x = e + ((((noise * e) >> 15) * noiseMix) >> 8);
+    e -= e >> SYNTH_DECAY_SHIFT;
+
+    // Resonator knalpot (Chamberlin SVF), keluaran band + sedikit low
+    lo += (svfF * bp) >> 15;
+    int32_t hp = x - lo - ((svfDamp * bp) >> 8);
+    bp += (svfF * hp) >> 15;
+    int32_t y = bp + (lo >> 2);
+
+    // DC blocker: pulsa satu arah punya DC
+    int32_t dc = y - dcIn + ((SYNTH_DC_POLE * dcOut + 16384) >> 15);
+    dcIn = y;
+    dcOut = dc;
+
+    if (level < SYNTH_UNITY) level += SYNTH_FADE_STEP;
+    int32_t v = (dc * level) >> 15;
+    if (v > 32767) v = 32767;
+    if (v < -32768) v = -32768;
+    out[i] = (int16_t)v;
+  }
+
+  phase = ph;
+  nextCyl = next;
+  env = e;
+  low = lo;
+  band = bp;
+  noiseSeed = seed;
+}
@@ -0,0 +1,163 @@
+#include "EnvelopeEngine.h"
+
+EnvelopeEngine envelopes;
+
+// Kurva bawaan: rev 300ms ke target / 400ms turun (sama dengan ramp lama),
+// upshift +30% 150ms lalu balik 200ms, downshift blip sinus cepat
+static const EnvCurve DEFAULT_CURVES[ENV_CURVE_COUNT] = {
+  {1, {{300, 1000, ENV_SHAPE_LINEAR}}},
+  {1, {{400, 0, ENV_SHAPE_LINEAR}}},
+  {2, {{150, 300, ENV_SHAPE_LINEAR}, {200, 0, ENV_SHAPE_LINEAR}}},
+  {2, {{80, 350, ENV_SHAPE_SINE}, {250, 0, ENV_SHAPE_SMOOTH}}},
+};
+
+static const EnvChannel CURVE_CHANNEL[ENV_CURVE_COUNT] = {
+  ENV_CH_REV, ENV_CH_REV, ENV_CH_SHIFT, ENV_CH_SHIFT,
+};
+
+static const char *const CURVE_KEYS[ENV_CURVE_COUNT] = {
+  "env_rev_up", "env_rev_down", "env_shift_up", "env_shift_down",
+};
+
+EnvelopeEngine::EnvelopeEngine() {
+  memcpy(curves, DEFAULT_CURVES, sizeof(curves));
+  memset(voices, 0, sizeof(voices));
+}
+
+const char *EnvelopeEngine::curveKey(EnvCurveId id) {
+  return id < ENV_CURVE_COUNT ? CURVE_KEYS[id] : "";
+}
+
+// Format tabel ringkas di header: "ms:level[shape],..." dengan level
+// permil (boleh negatif) dan shape l/s/c/e (linear, sinus, S-curve,
+// eksponensial).
+// Contoh upshift: "150:300,200:0"
+bool EnvelopeEngine::parseCurve(const char *text, EnvCurve &out) {
+  EnvCurve c;
+  memset(&c, 0, sizeof(c));
+  const char *p = text;
+
+  while (*p) {
+    if (c.count >= ENVELOPE_MAX_KEYS) return false;
+    char *end;
+    long ms = strtol(p, &end, 10);
+    if (end == p || *end != ':' || ms < 0 || ms > 60000) return false;
+    p = end + 1;
+    long level = strtol(p, &end, 10);
+    if (end == p || level < -1000 || level > 2000) return false;
+    p = end;
+
+    uint8_t shape = ENV_SHAPE_LINEAR;
+    if (*p == 's') shape = ENV_SHAPE_SINE, p++;
+    else if (*p == 'c') shape = ENV_SHAPE_SMOOTH, p++;
+    else if (*p == 'e') shape = ENV_SHAPE_EXP, p++;
+    else if (*p == 'l') p++;
+
+    c.keys[c.count++] = {(uint16_t)ms, (int16_t)level, shape};
+    if (*p == ',') p++;
+    else if (*p) return false;
+  }
+
+  if (c.count == 0) return false;
+  out = c;
+  return true;
+}
+
+// Kurva yang tidak ada di aset pakai bawaan. Voice yang sedang jalan
+// tetap memakai salinan kurvanya sendiri.
+void EnvelopeEngine::setCurves(const EnvCurveSet *set) {
+  portENTER_CRITICAL(&mux);
+  for (uint8_t i = 0; i < ENV_CURVE_COUNT; i++) {
+    curves[i] = (set && (set->mask & (1 << i))) ? set->curves[i] : DEFAULT_CURVES[i];
+  }
+  portEXIT_CRITICAL(&mux);
+}
+
+void EnvelopeEngine::trigger(EnvCurveId id) {
+  if (id >= ENV_CURVE_COUNT) return;
+  portENTER_CRITICAL(&mux);
+  Voice &v = voices[CURVE_CHANNEL[id]];
+  v.curve = curves[id];
+  v.seg = 0;
+  v.segMs = 0;
+  v.from = v.level;  // retrigger: lanjut dari level sekarang
+  portEXIT_CRITICAL(&mux);
+}
+
+// Progress segmen (Q16, sudah di-ease) untuk waktu t dari duration
+q16_t EnvelopeEngine::shapeAt(uint8_t shape, uint32_t t, uint32_t duration) {
+  return easeQ16(shape, q16Ratio(t, duration));
+}
+
+// Satu langkah ENVELOPE_TICK_MS; sisa waktu segmen yang selesai di tengah
+// tick dibawa ke segmen berikutnya
+void EnvelopeEngine::tick() {
+  for (uint8_t ch = 0; ch < ENV_CHANNEL_COUNT; ch++) {
+    Voice &v = voices[ch];
+    uint32_t t = v.segMs + ENVELOPE_TICK_MS;
+
+    while (v.seg < v.curve.count && t >= v.curve.keys[v.seg].ms) {
+      t -= v.curve.keys[v.seg].ms;
+      v.from = v.level = v.curve.keys[v.seg].level;
+      v.seg++;
+    }
+    if (v.seg >= v.curve.count) {
+      v.segMs = 0;
+      continue;
+    }
+
+    const EnvKey &k = v.curve.keys[v.seg];
+    v.segMs = t;
+    v.level = q16Lerp(v.from, k.level, shapeAt(k.shape, t, k.ms));
+  }
+}
+
+bool EnvelopeEngine::update(uint32_t nowMs) {
+  if (!started) {
+    lastTick = nowMs;
+    started = true;
+    return false;
+  }
+
+  // Tertinggal jauh (task tertahan): lompat, jangan kejar semua tick
+  uint32_t behind = nowMs - lastTick;
+  if (behind > ENVELOPE_MAX_CATCHUP * ENVELOPE_TICK_MS) {
+    lastTick = nowMs - ENVELOPE_MAX_CATCHUP * ENVELOPE_TICK_MS;
+  }
+
+  bool changed = false;
+  portENTER_CRITICAL(&mux);
+  while (nowMs - lastTick >= ENVELOPE_TICK_MS) {
+    lastTick += ENVELOPE_TICK_MS;
+    bool busy = voiceBusy(voices[ENV_CH_REV]) || voiceBusy(voices[ENV_CH_SHIFT]);
+    if (busy) {
+      tick();
+      changed = true;
+    }
+  }
+  portEXIT_CRITICAL(&mux);
+  return changed;
+}
+
+uint32_t EnvelopeEngine::apply(uint32_t baseRate, uint32_t revTarget) {
+  portENTER_CRITICAL(&mux);
+  int32_t rev = voices[ENV_CH_REV].level;
+  int32_t shift = voices[ENV_CH_SHIFT].level;
+  portEXIT_CRITICAL(&mux);
+
+  int64_t rate = (int64_t)baseRate + ((int64_t)revTarget - (int64_t)baseRate) * rev / 1000;
+  rate = rate * (1000 + shift) / 1000;
+  return rate > 0 ? (uint32_t)rate : 0;
+}
+
+bool EnvelopeEngine::isBusy(EnvChannel ch) {
+  return ch < ENV_CHANNEL_COUNT && voiceBusy(voices[ch]);
+}
+
+bool EnvelopeEngine::isBusy() {
+  return isBusy(ENV_CH_REV) || isBusy(ENV_CH_SHIFT);
+}
+
+int32_t EnvelopeEngine::getLevel(EnvChannel ch) {
+  return ch < ENV_CHANNEL_COUNT ? voices[ch].level : 0;
+}
@@ -0,0 +1,24 @@
+#include "FixedMath.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_attr.h"
+#endif
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
+
+static constexpr EaseTable LINEAR_TABLE = fixedmath::makeTable(EASE_LINEAR);
+static constexpr EaseTable SINE_TABLE = fixedmath::makeTable(EASE_SINE);
+static constexpr EaseTable SMOOTH_TABLE = fixedmath::makeTable(EASE_SMOOTH);
+static constexpr EaseTable EXP_TABLE = fixedmath::makeTable(EASE_EXP);
+
+// Ujung kurva harus tepat 0 dan 1.0, dicek saat compile
+static_assert(LINEAR_TABLE.v[0] == 0 && LINEAR_TABLE.v[EASE_LUT_SIZE - 1] == Q16_ONE, "ease linear");
+static_assert(SINE_TABLE.v[0] == 0 && SINE_TABLE.v[EASE_LUT_SIZE - 1] == Q16_ONE, "ease sine");
+static_assert(SMOOTH_TABLE.v[0] == 0 && SMOOTH_TABLE.v[EASE_LUT_SIZE - 1] == Q16_ONE, "ease smooth");
+static_assert(EXP_TABLE.v[0] == 0 && EXP_TABLE.v[EASE_LUT_SIZE - 1] == Q16_ONE, "ease exp");
+
+// Di DRAM supaya bisa dibaca dari ISR/render saat cache flash mati
+DRAM_ATTR const EaseTable EASE_TABLES[EASE_COUNT] = {
+  LINEAR_TABLE, SINE_TABLE, SMOOTH_TABLE, EXP_TABLE,
+};
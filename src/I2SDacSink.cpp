@@ -0,0 +1,101 @@
+#include "I2SDacSink.h"
+#include <driver/i2s.h>
+#include "AudioProfiler.h"
+
+#define AUDIO_I2S_PORT I2S_NUM_0
+
+// Install driver I2S mode built-in DAC, hanya channel kanan (DAC1 = GPIO25)
+bool I2SDacSink::begin(uint32_t sampleRate, AudioRenderFn render) {
+  rate = sampleRate;
+  renderFn = render;
+
+  i2s_config_t cfg = {};
+  cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN);
+  cfg.sample_rate = sampleRate;
+  cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+  cfg.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+  cfg.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+  cfg.intr_alloc_flags = 0;
+  cfg.dma_buf_count = AUDIO_DMA_BUF_COUNT;
+  cfg.dma_buf_len = AUDIO_BLOCK_SAMPLES;
+  cfg.use_apll = false;
+  cfg.tx_desc_auto_clear = true;  // DMA kosong = silence, bukan ulang buffer lama
+
+  if (i2s_driver_install(AUDIO_I2S_PORT, &cfg, 0, nullptr) != ESP_OK) {
+    Serial.println("❌ I2S driver install gagal");
+    return false;
+  }
+  i2s_set_pin(AUDIO_I2S_PORT, nullptr);
+  i2s_set_dac_mode(I2S_DAC_CHANNEL_RIGHT_EN);
+  i2s_zero_dma_buffer(AUDIO_I2S_PORT);
+
+  renderMutex = xSemaphoreCreateMutex();
+  running = true;
+
+  xTaskCreatePinnedToCore(
+    outputTaskWrapper,
+    "AudioOut",
+    4096,
+    this,
+    AUDIO_TASK_PRIORITY,
+    &outputTaskHandle,
+    AUDIO_TASK_CORE
+  );
+
+  Serial.printf("✅ Audio output: I2S DMA @ %lu Hz (%d x %d sample)\n",
+                rate, AUDIO_DMA_BUF_COUNT, AUDIO_BLOCK_SAMPLES);
+  return true;
+}
+
+void I2SDacSink::end() {
+  running = false;
+  pause();
+  if (outputTaskHandle) {
+    vTaskDelete(outputTaskHandle);
+    outputTaskHandle = nullptr;
+  }
+  i2s_driver_uninstall(AUDIO_I2S_PORT);
+}
+
+// Tunggu blok yang sedang dirender selesai, lalu output silence
+void I2SDacSink::pause() {
+  paused = true;
+  if (renderMutex) {
+    xSemaphoreTake(renderMutex, portMAX_DELAY);
+    xSemaphoreGive(renderMutex);
+  }
+}
+
+void I2SDacSink::resume() {
+  paused = false;
+}
+
+void I2SDacSink::outputTaskWrapper(void *parameter) {
+  static_cast<I2SDacSink *>(parameter)->outputTask();
+}
+
+void I2SDacSink::outputTask() {
+  while (running) {
+    xSemaphoreTake(renderMutex, portMAX_DELAY);
+    if (paused || !renderFn) {
+      memset(block, 128, sizeof(block));
+    } else {
+      AUDIO_PROFILE_RENDER_BEGIN();
+      renderFn(block, AUDIO_BLOCK_SAMPLES);
+      AUDIO_PROFILE_RENDER_END();
+    }
+    xSemaphoreGive(renderMutex);
+
+    // Built-in DAC ambil 8 bit atas tiap slot 16-bit, kiri = kanan
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      uint16_t v = (uint16_t)block[i] << 8;
+      frames[i * 2] = v;
+      frames[i * 2 + 1] = v;
+    }
+
+    // Blocking sampai ada buffer DMA kosong - ini yang mem-pacing task
+    size_t written = 0;
+    i2s_write(AUDIO_I2S_PORT, frames, sizeof(frames), &written, portMAX_DELAY);
+  }
+  vTaskDelete(nullptr);
+}
@@ -0,0 +1,108 @@
+#include "ImaAdpcm.h"
+
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
+
+// Tabel standar IMA-ADPCM (di DRAM, dibaca dari render)
+static const DRAM_ATTR int16_t stepTable[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+};
+
+static const DRAM_ATTR int8_t indexTable[16] = {
+  -1, -1, -1, -1, 2, 4, 6, 8,
+  -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// Satu nibble: diff = step * (n + 0.5) / 4 dari shift + add saja
+static inline int32_t IRAM_ATTR decodeNibble(uint8_t nibble, int32_t &predictor, int32_t &index) {
+  int32_t step = stepTable[index];
+  int32_t diff = step >> 3;
+  if (nibble & 4) diff += step;
+  if (nibble & 2) diff += step >> 1;
+  if (nibble & 1) diff += step >> 2;
+
+  predictor += (nibble & 8) ? -diff : diff;
+  if (predictor > 32767) predictor = 32767;
+  else if (predictor < -32768) predictor = -32768;
+
+  index += indexTable[nibble];
+  if (index < 0) index = 0;
+  else if (index > 88) index = 88;
+  return predictor;
+}
+
+// 16-bit signed -> 8-bit unsigned (dibulatkan, offset 128)
+static inline uint8_t IRAM_ATTR toPCM8(int32_t s) {
+  int32_t v = ((s + 128) >> 8) + 128;
+  return (uint8_t)(v > 255 ? 255 : v);
+}
+
+uint32_t IRAM_ATTR ImaAdpcm::decodeBlock(const uint8_t *block, uint32_t blockBytes, uint8_t *out) {
+  int32_t predictor = (int16_t)(block[0] | (block[1] << 8));
+  int32_t index = block[2];
+  if (index > 88) index = 88;
+
+  const uint8_t *p = block + ADPCM_BLOCK_HEADER;
+  const uint8_t *end = block + blockBytes;
+  while (p < end) {
+    uint8_t b = *p++;
+    *out++ = toPCM8(decodeNibble(b & 0x0F, predictor, index));
+    *out++ = toPCM8(decodeNibble(b >> 4, predictor, index));
+  }
+  return samplesPerBlock(blockBytes);
+}
+
+// Encoder standar: pilih nibble dari selisih terhadap predictor, lalu
+// update predictor lewat decoder yang sama supaya state selalu sinkron
+void ImaAdpcm::encodeBlock(const uint8_t *pcm, uint32_t count, uint8_t *block,
+                           uint32_t blockBytes, ImaAdpcmState &state) {
+  uint32_t capacity = samplesPerBlock(blockBytes);
+  if (count > capacity) count = capacity;
+
+  // Predictor awal = sample pertama, jadi blok mulai tanpa lompatan
+  int32_t predictor = count ? ((int32_t)pcm[0] - 128) << 8 : 0;
+  int32_t index = state.index;
+
+  block[0] = (uint8_t)(predictor & 0xFF);
+  block[1] = (uint8_t)((predictor >> 8) & 0xFF);
+  block[2] = (uint8_t)index;
+  block[3] = 0;
+
+  uint8_t *p = block + ADPCM_BLOCK_HEADER;
+  for (uint32_t i = 0; i < capacity; i++) {
+    // Padding blok terakhir: ulangi sample terakhir
+    uint32_t src = (i < count) ? i : (count ? count - 1 : 0);
+    int32_t sample = count ? ((int32_t)pcm[src] - 128) << 8 : 0;
+
+    int32_t step = stepTable[index];
+    int32_t diff = sample - predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+      nibble = 8;
+      diff = -diff;
+    }
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 1; }
+
+    decodeNibble(nibble, predictor, index);
+
+    if (i & 1) {
+      *p++ |= (uint8_t)(nibble << 4);
+    } else {
+      *p = nibble;
+    }
+  }
+
+  state.predictor = (int16_t)predictor;
+  state.index = (uint8_t)index;
+}
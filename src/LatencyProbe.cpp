@@ -0,0 +1,139 @@
+#include "LatencyProbe.h"
+
+// Blok yang sudah dirender tapi belum terdengar: timer sink double
+// buffer (1 blok antri), I2S antri sebanyak buffer DMA
+#if AUDIO_OUTPUT_BACKEND == AUDIO_BACKEND_I2S
+#define LATENCY_QUEUE_BLOCKS AUDIO_DMA_BUF_COUNT
+#else
+#define LATENCY_QUEUE_BLOCKS 1
+#endif
+#define LATENCY_STALE_US ((uint32_t)LATENCY_STALE_MS * 1000)
+#define LATENCY_OUTPUT_US ((uint32_t)((uint64_t)LATENCY_QUEUE_BLOCKS * AUDIO_BLOCK_SAMPLES * 1000000ULL / AUDIO_OUTPUT_RATE))
+
+LatencyProbe latencyProbe;
+
+static const char *const sourceNames[LAT_SOURCE_COUNT] = {"adc", "btn", "ble", "can"};
+
+LatencyProbe::LatencyProbe() {
+  memset(sources, 0, sizeof(sources));
+}
+
+const char *LatencyProbe::sourceName(LatencySource src) {
+  return src < LAT_SOURCE_COUNT ? sourceNames[src] : "?";
+}
+
+// Waktu ditulis sebelum state, render hanya membaca waktu setelah
+// melihat EVENT_APPLIED
+void LatencyProbe::stamp(LatencySource src) {
+  if (src >= LAT_SOURCE_COUNT) return;
+  SourceState &s = sources[src];
+  uint32_t now = micros();
+  // Digabung ke event yang belum selesai, kecuali event itu sudah basi
+  if (s.state == EVENT_APPLIED) return;
+  if (s.state == EVENT_ARRIVED && now - s.arrivedUs < LATENCY_STALE_US) return;
+  s.arrivedUs = now;
+  s.state = EVENT_ARRIVED;
+}
+
+void LatencyProbe::applied(LatencySource src) {
+  if (src >= LAT_SOURCE_COUNT) return;
+  SourceState &s = sources[src];
+  if (s.state != EVENT_ARRIVED) return;
+  s.state = (micros() - s.arrivedUs < LATENCY_STALE_US) ? EVENT_APPLIED : EVENT_IDLE;
+}
+
+void LatencyProbe::cancel(LatencySource src) {
+  if (src >= LAT_SOURCE_COUNT) return;
+  if (sources[src].state == EVENT_ARRIVED) sources[src].state = EVENT_IDLE;
+}
+
+void IRAM_ATTR LatencyProbe::onRender() {
+  uint32_t now = 0;
+  for (uint8_t i = 0; i < LAT_SOURCE_COUNT; i++) {
+    SourceState &s = sources[i];
+    if (s.state != EVENT_APPLIED) continue;
+    if (now == 0) now = micros();
+    uint32_t age = now - s.arrivedUs;
+    if (age < LATENCY_STALE_US) record(s, age + LATENCY_OUTPUT_US);
+    s.state = EVENT_IDLE;
+  }
+}
+
+void IRAM_ATTR LatencyProbe::record(SourceState &s, uint32_t us) {
+  s.buckets[bucketOf(us)]++;
+  s.count++;
+  if (us > s.maxUs) s.maxUs = us;
+}
+
+// 0-7us linear, di atasnya 8 bucket per oktaf (3 bit mantissa)
+uint8_t IRAM_ATTR LatencyProbe::bucketOf(uint32_t us) {
+  if (us < 8) return (uint8_t)us;
+  uint32_t e = 31 - __builtin_clz(us);
+  uint32_t idx = (e - 2) * 8 + ((us >> (e - 3)) & 7);
+  return idx < LATENCY_BUCKETS ? (uint8_t)idx : LATENCY_BUCKETS - 1;
+}
+
+uint32_t LatencyProbe::bucketUpper(uint8_t idx) {
+  if (idx < 8) return idx;
+  uint32_t e = idx / 8 + 2;
+  uint32_t m = idx % 8;
+  return ((8 + m) << (e - 3)) + (1UL << (e - 3)) - 1;
+}
+
+// Persentil dari histogram = batas atas bucket, max tetap exact
+bool LatencyProbe::getStats(LatencySource src, LatencyStats &stats) {
+  memset(&stats, 0, sizeof(stats));
+  if (src >= LAT_SOURCE_COUNT) return false;
+  const SourceState &s = sources[src];
+  stats.count = s.count;
+  stats.maxUs = s.maxUs;
+  if (stats.count == 0) return false;
+
+  uint64_t need50 = ((uint64_t)stats.count * 50 + 99) / 100;
+  uint64_t need99 = ((uint64_t)stats.count * 99 + 99) / 100;
+  uint64_t cum = 0;
+  for (uint16_t i = 0; i < LATENCY_BUCKETS; i++) {
+    cum += s.buckets[i];
+    if (stats.p50Us == 0 && cum >= need50) stats.p50Us = bucketUpper(i);
+    if (cum >= need99) {
+      stats.p99Us = bucketUpper(i);
+      break;
+    }
+  }
+  if (stats.p50Us > stats.maxUs) stats.p50Us = stats.maxUs;
+  if (stats.p99Us > stats.maxUs) stats.p99Us = stats.maxUs;
+  return true;
+}
+
+// Satu baris per sumber, ms: "adc n=12 p50=35.8 p99=410.2 max=602.4"
+String LatencyProbe::report() {
+  String out;
+  char line[72];
+  for (uint8_t i = 0; i < LAT_SOURCE_COUNT; i++) {
+    LatencyStats st;
+    if (getStats((LatencySource)i, st)) {
+      snprintf(line, sizeof(line), "%s n=%lu p50=%.1f p99=%.1f max=%.1f\n", sourceNames[i],
+               (unsigned long)st.count, st.p50Us / 1000.0f, st.p99Us / 1000.0f, st.maxUs / 1000.0f);
+    } else {
+      snprintf(line, sizeof(line), "%s n=0\n", sourceNames[i]);
+    }
+    out += line;
+  }
+  return out;
+}
+
+void LatencyProbe::printReport() {
+  Serial.printf("⏱️ Latency input->suara (ms, termasuk %lu us antrian DAC):\n%s",
+                (unsigned long)LATENCY_OUTPUT_US, report().c_str());
+}
+
+// Histogram dikosongkan, event yang sedang berjalan tetap diukur
+void LatencyProbe::reset() {
+  for (uint8_t i = 0; i < LAT_SOURCE_COUNT; i++) {
+    SourceState &s = sources[i];
+    s.count = 0;
+    s.maxUs = 0;
+    memset(s.buckets, 0, sizeof(s.buckets));
+  }
+  Serial.println("⏱️ Latency histogram di-reset");
+}
@@ -0,0 +1,100 @@
+#include "LoopAnalyzer.h"
+
+// Level zero crossing = rata-rata segmen (data 8-bit unsigned, DC tidak
+// selalu tepat di 128)
+static uint8_t crossingLevel(const uint8_t *data, uint32_t length) {
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < length; i++) sum += data[i];
+  return (uint8_t)(sum / length);
+}
+
+// Kumpulkan zero crossing naik yang punya LOOP_MATCH_WINDOW sample di kiri
+// dan kanan. fromEnd = scan dari belakang (kandidat end, loop sepanjang mungkin).
+static uint32_t collectCrossings(const uint8_t *data, uint32_t length, uint8_t level,
+                                 uint32_t *out, bool fromEnd) {
+  const uint32_t W = LOOP_MATCH_WINDOW;
+  uint32_t count = 0;
+  if (length < 2 * W + 1) return 0;
+
+  for (uint32_t n = 0; n < length - 2 * W && count < LOOP_MAX_CANDIDATES; n++) {
+    uint32_t i = fromEnd ? (length - W - 1 - n) : (W + n);
+    if (data[i - 1] < level && data[i] >= level) {
+      out[count++] = i;
+    }
+  }
+  return count;
+}
+
+// SAD sample + SAD slope di jendela [-W, W) sekitar kedua titik.
+// Berhenti begitu melewati `limit` (kandidat terbaik sejauh ini).
+static uint32_t matchCost(const uint8_t *a, const uint8_t *b, uint32_t limit) {
+  const int32_t W = LOOP_MATCH_WINDOW;
+  uint32_t cost = 0;
+
+  for (int32_t k = -W; k < W - 1; k++) {
+    int32_t d = (int32_t)a[k] - b[k];
+    int32_t slope = ((int32_t)a[k + 1] - a[k]) - ((int32_t)b[k + 1] - b[k]);
+    cost += (uint32_t)(d < 0 ? -d : d) + (uint32_t)(slope < 0 ? -slope : slope);
+    if (cost >= limit) break;
+  }
+  return cost;
+}
+
+uint32_t LoopAnalyzer::searchSpan(uint32_t length) {
+  uint32_t span = length / 4;
+  return span > LOOP_SEARCH_SPAN ? LOOP_SEARCH_SPAN : span;
+}
+
+bool LoopAnalyzer::find(const uint8_t *data, uint32_t length, LoopPoints &loop) {
+  uint32_t span = searchSpan(length);
+  return findInSegments(data, span, data + length - span, span, length - span, loop);
+}
+
+bool LoopAnalyzer::findInSegments(const uint8_t *head, uint32_t headLen,
+                                  const uint8_t *tail, uint32_t tailLen,
+                                  uint32_t tailOffset, LoopPoints &loop) {
+  uint32_t starts[LOOP_MAX_CANDIDATES];
+  uint32_t ends[LOOP_MAX_CANDIDATES];
+
+  if (headLen < 4 * LOOP_MATCH_WINDOW || tailLen < 4 * LOOP_MATCH_WINDOW) return false;
+
+  uint8_t level = crossingLevel(head, headLen);
+  uint32_t nStart = collectCrossings(head, headLen, level, starts, false);
+  uint32_t nEnd = collectCrossings(tail, tailLen, level, ends, true);
+  if (nStart == 0 || nEnd == 0) return false;
+
+  uint32_t best = UINT32_MAX;
+  uint32_t bestStart = 0;
+  uint32_t bestEnd = 0;
+
+  for (uint32_t e = 0; e < nEnd; e++) {
+    for (uint32_t s = 0; s < nStart; s++) {
+      uint32_t cost = matchCost(head + starts[s], tail + ends[e], best);
+      if (cost < best) {
+        best = cost;
+        bestStart = starts[s];
+        bestEnd = ends[e];
+      }
+    }
+  }
+
+  loop.start = bestStart;
+  loop.end = tailOffset + bestEnd;
+  return loop.end > loop.start;
+}
+
+void LoopAnalyzer::applyCrossfadeTail(uint8_t *data, const LoopPoints &loop, uint32_t fadeLen) {
+  if (fadeLen > loop.start) fadeLen = loop.start;
+  if (fadeLen > (loop.end - loop.start) / 2) fadeLen = (loop.end - loop.start) / 2;
+  if (fadeLen == 0) return;
+
+  uint8_t *dst = data + loop.end - fadeLen;
+  const uint8_t *src = data + loop.start - fadeLen;
+
+  // Bobot naik ke 1.0 di sample terakhir: data[end-1] = data[start-1]
+  for (uint32_t k = 0; k < fadeLen; k++) {
+    int32_t a = dst[k];
+    int32_t b = src[k];
+    dst[k] = (uint8_t)(a + ((b - a) * (int32_t)(k + 1)) / (int32_t)fadeLen);
+  }
+}
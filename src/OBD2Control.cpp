@@ -1,4 +1,5 @@
 #include "OBD2Control.h"
+#include "LatencyProbe.h"
 
 OBD2Control obd2;
 
@@ -119,6 +120,9 @@ void OBD2Control::requestRPM() {
   uint8_t data[8];
   if (readCANResponse(data, 8, CAN_RPM.response)) {
     if (data[1] == 0x41 && data[2] == 0x0C) {
+      // Event latency CAN; ditutup oleh pemakai getRPM() yang mengubah
+      // suara (belum ada, jadi histogram "can" masih kosong)
+      latencyProbe.stamp(LAT_CAN);
       uint16_t rpm = ((data[3] * 256) + data[4]) / 4;
       obd2_rpm = constrain(rpm, 0, MAX_RPM);
     }
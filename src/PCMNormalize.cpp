@@ -0,0 +1,169 @@
+#include "PCMNormalize.h"
+#include <string.h>
+
+#define SWAR_HIGH 0x80808080UL
+#define SWAR_LOW7 0x7F7F7F7FUL
+
+// Per byte: 0xFF kalau a >= b (unsigned), 0x00 kalau tidak.
+// (a|0x80) - (b&0x7F) tidak pernah borrow antar byte, bit 7 hasilnya =
+// perbandingan 7 bit bawah; bit 7 asli a/b menentukan sisanya.
+static inline uint32_t swarGreaterEqual(uint32_t a, uint32_t b) {
+  uint32_t low = (a | SWAR_HIGH) - (b & SWAR_LOW7);
+  uint32_t ge = ((a & ~b) | (~(a ^ b) & low)) & SWAR_HIGH;
+  return (ge >> 7) * 0xFFUL;
+}
+
+void PCMNormalize::findRange(const uint8_t *data, size_t length, uint8_t &minValue, uint8_t &maxValue) {
+  uint8_t lo = minValue;
+  uint8_t hi = maxValue;
+  size_t i = 0;
+
+  // Head sampai alignment 4 byte
+  while (i < length && ((uintptr_t)(data + i) & 3)) {
+    if (data[i] > hi) hi = data[i];
+    if (data[i] < lo) lo = data[i];
+    i++;
+  }
+
+  // Body: 4 lane min/max paralel dalam satu word (memcpy aligned = 1 load)
+  if (length - i >= 4) {
+    const uint8_t *words = data + i;
+    size_t wordCount = (length - i) >> 2;
+    uint32_t vmin, vmax;
+    memcpy(&vmin, words, 4);
+    vmax = vmin;
+
+    for (size_t w = 1; w < wordCount; w++) {
+      uint32_t v;
+      memcpy(&v, words + (w << 2), 4);
+      uint32_t geMax = swarGreaterEqual(v, vmax);
+      vmax = (v & geMax) | (vmax & ~geMax);
+      uint32_t geMin = swarGreaterEqual(v, vmin);
+      vmin = (vmin & geMin) | (v & ~geMin);
+    }
+
+    // Reduksi 4 lane
+    for (int lane = 0; lane < 4; lane++) {
+      uint8_t mx = (uint8_t)(vmax >> (lane * 8));
+      uint8_t mn = (uint8_t)(vmin >> (lane * 8));
+      if (mx > hi) hi = mx;
+      if (mn < lo) lo = mn;
+    }
+    i += wordCount << 2;
+  }
+
+  // Tail
+  for (; i < length; i++) {
+    if (data[i] > hi) hi = data[i];
+    if (data[i] < lo) lo = data[i];
+  }
+
+  minValue = lo;
+  maxValue = hi;
+}
+
+// Rumus sama persis dengan normalizeReference, tapi dievaluasi hanya
+// untuk 256 kemungkinan nilai input
+void PCMNormalize::buildLUT(uint8_t minValue, uint8_t maxValue, uint8_t lut[256]) {
+  float centerPoint = (maxValue + minValue) * 0.5f;
+  float dynamicRange = (float)(maxValue - minValue);
+  float scaleFactor, offset;
+
+  if (dynamicRange < 2.0f) {
+    scaleFactor = 1.0f;
+    offset = 127.0f - centerPoint;
+  } else {
+    scaleFactor = 218.0f / dynamicRange;
+    float scaledCenter = centerPoint * scaleFactor;
+    offset = 127.0f - scaledCenter;
+  }
+
+  for (int v = 0; v < 256; v++) {
+    float normalizedValue = (v * scaleFactor) + offset;
+    if (normalizedValue < 19)  normalizedValue = 19;
+    if (normalizedValue > 237) normalizedValue = 237;
+    lut[v] = (uint8_t)normalizedValue;
+  }
+}
+
+// Remap word-at-a-time: 1 load + 4 lookup + 1 store per 4 sample
+void PCMNormalize::applyLUT(uint8_t *data, size_t length, const uint8_t lut[256]) {
+  size_t i = 0;
+
+  while (i < length && ((uintptr_t)(data + i) & 3)) {
+    data[i] = lut[data[i]];
+    i++;
+  }
+
+  uint8_t *words = data + i;
+  size_t wordCount = (length - i) >> 2;
+  for (size_t w = 0; w < wordCount; w++) {
+    uint32_t v;
+    memcpy(&v, words + (w << 2), 4);
+    v = (uint32_t)lut[v & 0xFF] |
+        ((uint32_t)lut[(v >> 8) & 0xFF] << 8) |
+        ((uint32_t)lut[(v >> 16) & 0xFF] << 16) |
+        ((uint32_t)lut[v >> 24] << 24);
+    memcpy(words + (w << 2), &v, 4);
+  }
+  i += wordCount << 2;
+
+  for (; i < length; i++) {
+    data[i] = lut[data[i]];
+  }
+}
+
+void PCMNormalize::normalize(uint8_t *data, size_t length) {
+  if (!data || length == 0) return;
+
+  uint8_t minValue = 255;
+  uint8_t maxValue = 0;
+  uint8_t lut[256];
+  findRange(data, length, minValue, maxValue);
+  buildLUT(minValue, maxValue, lut);
+  applyLUT(data, length, lut);
+}
+
+/*✅ Perbaikan Variable Names:
+A → maxValue - Nilai maksimum dalam data
+B → minValue - Nilai minimum dalam data
+C → centerPoint - Titik tengah range
+X → dynamicRange - Range dinamis audio
+K → scaleFactor - Faktor skala normalisasi
+T → offset - Offset untuk centering
+Z → scaledCenter - Center point setelah scaling
+val → normalizedValue - Nilai setelah normalisasi
+*/
+void PCMNormalize::normalizeReference(uint8_t *data, size_t length) {
+  if (!data || length == 0) return;
+
+  uint8_t maxValue = 0;
+  uint8_t minValue = 255;
+
+  // Find min/max values in audio data
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] > maxValue) maxValue = data[i];
+    if (data[i] < minValue) minValue = data[i];
+  }
+
+  float centerPoint = (maxValue + minValue) * 0.5f;
+  float dynamicRange = (float)(maxValue - minValue);
+  float scaleFactor, offset;
+
+  if (dynamicRange < 2.0f) {
+    scaleFactor = 1.0f;
+    offset = 127.0f - centerPoint;
+  } else {
+    scaleFactor = 218.0f / dynamicRange;
+    float scaledCenter = centerPoint * scaleFactor;
+    offset = 127.0f - scaledCenter;
+  }
+
+  // Apply normalization to keep values in range 19-237
+  for (size_t i = 0; i < length; i++) {
+    float normalizedValue = (data[i] * scaleFactor) + offset;
+    if (normalizedValue < 19)  normalizedValue = 19;
+    if (normalizedValue > 237) normalizedValue = 237;
+    data[i] = (uint8_t)normalizedValue;
+  }
+}
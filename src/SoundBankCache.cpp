@@ -0,0 +1,264 @@
+#include "SoundBankCache.h"
+#include "AudioSink.h"
+
+SoundBankCache soundCache;
+
+SoundBankCache::SoundBankCache() {
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    entries[i].lastUsed = 0;
+    entries[i].stale = false;
+    entries[i].filling = false;
+  }
+}
+
+// Budget ikut PSRAM: dengan PSRAM semua register biasanya muat sekaligus
+void SoundBankCache::begin(AudioSink *outputSink) {
+  sink = outputSink;
+  if (!mutex) mutex = xSemaphoreCreateRecursiveMutex();
+
+  usePSRAM = psramFound();
+  budget = usePSRAM ? AUDIO_CACHE_BUDGET_PSRAM : AUDIO_CACHE_BUDGET_RAM;
+  Serial.printf("✅ Register cache: %lu KB (%s)\n", budget / 1024, usePSRAM ? "PSRAM" : "RAM");
+}
+
+// Load register bisa datang dari ADC task (tombol) dan BLE task (command)
+void SoundBankCache::lock() {
+  if (mutex) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+}
+
+void SoundBankCache::unlock() {
+  if (mutex) xSemaphoreGiveRecursive(mutex);
+}
+
+// Bank register yang masih valid di cache, atau nullptr (cache miss)
+EngineSoundBank *SoundBankCache::find(const char *folder) {
+  lock();
+  EngineSoundBank *found = nullptr;
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (e.stale || e.filling || e.bank.getCellCount() == 0 || e.folder != folder) continue;
+    e.lastUsed = ++useCounter;
+    found = &e.bank;
+    break;
+  }
+  unlock();
+  return found;
+}
+
+// Slot untuk register `folder`: pakai ulang slot lama register ini
+// (stale) kalau tidak sedang dirender, slot kosong, atau evict sesuai
+// evictRank. Register aktif yang di-reload diisi ke slot lain, jadi bank
+// lama tetap bunyi selama diisi dan swap-nya di-crossfade (slot lama
+// stale, di-evict duluan begitu tidak dirender). Slot ditandai filling
+// sampai commit/drop. nullptr kalau register ini sedang diisi task lain
+// atau semua slot sedang diisi.
+EngineSoundBank *SoundBankCache::acquire(const char *folder) {
+  lock();
+  SoundCacheEntry *slot = nullptr;
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (e.folder != folder) continue;
+    if (e.filling) {
+      unlock();
+      return nullptr;
+    }
+    if (!slot && !inUse(e)) slot = &e;
+  }
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS && !slot; i++) {
+    if (entries[i].folder.length() == 0) slot = &entries[i];
+  }
+  if (!slot) slot = lruVictim(nullptr);
+  if (!slot) {
+    unlock();
+    return nullptr;
+  }
+
+  release(*slot);
+  slot->folder = folder;
+  slot->lastUsed = ++useCounter;
+  slot->filling = true;
+  unlock();
+  return &slot->bank;
+}
+
+// Slot selesai diisi: boleh ditemukan find dan di-evict lagi. Kalau file
+// berubah selama diisi (invalidate), slot tetap stale.
+void SoundBankCache::commit(EngineSoundBank *bank) {
+  lock();
+  SoundCacheEntry *e = entryFor(bank);
+  if (e) e->filling = false;
+  unlock();
+}
+
+// Buang slot yang gagal diisi (tidak ada cell yang berhasil di-load)
+void SoundBankCache::drop(EngineSoundBank *bank) {
+  lock();
+  SoundCacheEntry *e = entryFor(bank);
+  if (e) release(*e);
+  unlock();
+}
+
+// Alokasi buffer rekaman untuk bank yang sedang diisi. Evict register lain
+// (LRU) sampai muat budget; kalau malloc tetap gagal, evict lagi lalu coba
+// ulang. Register yang sedang diisi boleh melebihi budget sendirian.
+uint8_t *SoundBankCache::allocate(uint32_t length, EngineSoundBank *filling) {
+  lock();
+  while (getUsedBytes() + length > budget && evictLRU(filling)) {}
+
+  uint8_t *buffer = nullptr;
+  for (;;) {
+    buffer = (uint8_t *)(usePSRAM ? ps_malloc(length) : malloc(length));
+    if (buffer || !evictLRU(filling)) break;
+  }
+  unlock();
+
+  if (!buffer) {
+    Serial.println("❌ RAM tidak cukup");
+  }
+  return buffer;
+}
+
+// Muat tanpa evict register lain (untuk preload)
+bool SoundBankCache::fits(uint32_t length) {
+  lock();
+  bool ok = getUsedBytes() + length <= budget;
+  unlock();
+  return ok;
+}
+
+// Ganti bank yang dirender: satu tulis pointer 32-bit. Bank lama dicatat
+// sebagai retired karena render yang sedang jalan mungkin masih memakainya.
+void SoundBankCache::activate(EngineSoundBank *bank) {
+  lock();
+  if (bank != activeBank) {
+    retiredBank = activeBank;
+    __sync_synchronize();  // render harus lihat retired sebelum bank baru
+    activeBank = bank;
+  }
+  SoundCacheEntry *e = entryFor(bank);
+  if (e) e->lastUsed = ++useCounter;
+  unlock();
+}
+
+// Lepas slot stale register `folder` yang sudah tidak aktif (bank lama
+// setelah reload). Kalau masih retired, release menunggu blok render.
+void SoundBankCache::dropStale(const char *folder) {
+  lock();
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (e.folder != folder || !e.stale || e.filling || &e.bank == activeBank) continue;
+    release(e);
+  }
+  unlock();
+}
+
+// Tandai register yang filenya berubah (path file atau folder). Buffer
+// tidak di-free di sini; slot diisi ulang saat register dipakai lagi.
+void SoundBankCache::invalidate(const char *path) {
+  lock();
+  String p = path;
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (e.folder.length() == 0) continue;
+    if (p == e.folder || p.startsWith(e.folder + "/")) {
+      e.stale = true;
+    }
+  }
+  unlock();
+}
+
+void SoundBankCache::invalidateAll() {
+  lock();
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    if (entries[i].folder.length() > 0) entries[i].stale = true;
+  }
+  unlock();
+}
+
+// Mutex rekursif: aman dipanggil dari dalam allocate/printStatus
+uint32_t SoundBankCache::getUsedBytes() {
+  uint32_t total = 0;
+  lock();
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    total += entries[i].bank.getTotalBytes();
+  }
+  unlock();
+  return total;
+}
+
+void SoundBankCache::printStatus() {
+  lock();
+  Serial.printf("📦 Register cache: %lu/%lu KB\n", getUsedBytes() / 1024, budget / 1024);
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (e.folder.length() == 0) continue;
+    Serial.printf("   %s: %d cell, %lu bytes%s%s%s\n", e.folder.c_str(),
+                  e.bank.getCellCount(), e.bank.getTotalBytes(),
+                  &e.bank == activeBank ? " [aktif]" : "",
+                  e.stale ? " [stale]" : "", e.filling ? " [diisi]" : "");
+  }
+  unlock();
+}
+
+SoundCacheEntry *SoundBankCache::entryFor(EngineSoundBank *bank) {
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    if (&entries[i].bank == bank) return &entries[i];
+  }
+  return nullptr;
+}
+
+bool SoundBankCache::inUse(const SoundCacheEntry &entry) const {
+  return &entry.bank == activeBank || &entry.bank == retiredBank;
+}
+
+// Urutan evict: slot stale (isinya toh harus dibaca ulang), lalu LRU,
+// bank yang sedang diputar/di-crossfade paling akhir
+uint8_t SoundBankCache::evictRank(SoundCacheEntry &entry) {
+  if (inUse(entry)) return 2;
+  return entry.stale ? 0 : 1;
+}
+
+// Slot terisi dengan rank evict terendah (LRU di rank yang sama), kecuali
+// `keep` dan slot yang sedang diisi
+SoundCacheEntry *SoundBankCache::lruVictim(EngineSoundBank *keep) {
+  SoundCacheEntry *victim = nullptr;
+  for (uint8_t i = 0; i < AUDIO_CACHE_SLOTS; i++) {
+    SoundCacheEntry &e = entries[i];
+    if (&e.bank == keep || e.filling || e.folder.length() == 0) continue;
+    if (!victim) { victim = &e; continue; }
+    uint8_t rank = evictRank(e);
+    uint8_t victimRank = evictRank(*victim);
+    if (rank < victimRank || (rank == victimRank && e.lastUsed < victim->lastUsed)) {
+      victim = &e;
+    }
+  }
+  return victim;
+}
+
+// Evict satu slot terisi kecuali `keep` dan slot yang sedang diisi
+bool SoundBankCache::evictLRU(EngineSoundBank *keep) {
+  SoundCacheEntry *victim = lruVictim(keep);
+  if (!victim || victim->bank.getCellCount() == 0) return false;
+
+  Serial.printf("♻️ Evict register cache: %s\n", victim->folder.c_str());
+  release(*victim);
+  return true;
+}
+
+// Free isi slot. Kalau bank ini sedang/baru saja dirender, pause sink dulu
+// (pause menunggu blok yang sedang dirender selesai).
+void SoundBankCache::release(SoundCacheEntry &entry) {
+  EngineSoundBank *bank = &entry.bank;
+  bool rendering = inUse(entry);
+
+  if (rendering && sink) sink->pause();
+  if (bank == activeBank) activeBank = nullptr;
+  if (rendering) retiredBank = nullptr;
+  bank->clear();
+  if (rendering && sink) sink->resume();
+
+  entry.folder = "";
+  entry.stale = false;
+  entry.filling = false;
+  entry.lastUsed = 0;
+}
@@ -1,35 +1,47 @@
 #include "SystemManager.h"
 #include "VolumeControl.h"
+#include "SoundBankCache.h"
+#include "EffectMixer.h"
+#include "LatencyProbe.h"
+#include "AudioProfiler.h"
+
+SystemManager* SystemManager::instance = nullptr;
 
 SystemManager::SystemManager() {}
 
 void SystemManager::begin(AudioPlayer* audioPlayer) {
+  instance = this;
   player = audioPlayer;
+  audioLoader.setCallback(&SystemManager::onSoundLoaded);
   buttons.begin();
   leds.begin();
   ble.begin();
   
   leds.setRegister(currentRegister);
   ble.setCurrentRegister(currentRegister);
+  effectMixer.load();
+  preloadSounds();
   Serial.println("✅ System ready");
 }
 
-void SystemManager::update() {
-  updateButtons();
-  updateLEDs();
-  updateBLE();
-}
-
 void SystemManager::updateButtons() {
   buttons.update();
   
-  // Only update effects when needed
-  if (isRevving || isRevDown) {
-    updateRev();
-  } else if (isShifting) {
-    updateShift();
+  // Register selesai di-load (flag dari loader task): start di task ini
+  // supaya tidak balapan dengan tombol play/stop
+  if (loadDone) {
+    loadDone = false;
+    startLoadedSound();
   }
   
+  // Suara shutdown selesai: baru mute output
+  if (stopPending && effectMixer.isIdle()) {
+    stopPending = false;
+    if (player && !isPlaying) player->stopPlayback();
+  }
+  
+  updateDrive();
+  
   if (currentMode == MODE_NORMAL) {
     handleNormalMode();
   } else {
@@ -40,6 +52,16 @@ void SystemManager::updateButtons() {
 void SystemManager::updateBLE() {
   ble.update();
   handleBLECommands();
+  
+#if DIAG_REPORT_MS > 0
+  if (millis() - lastDiagReport >= DIAG_REPORT_MS) {
+    lastDiagReport = millis();
+    latencyProbe.printReport();
+#if AUDIO_PROFILER
+    audioProfiler.printReport();
+#endif
+  }
+#endif
 }
 
 void SystemManager::updateLEDs() {
@@ -73,6 +95,10 @@ void SystemManager::handleProgrammingMode() {
     switchRegister();
   }
   
+  if (buttons.isButtonBPressed()) {
+    latencyProbe.cancel(LAT_BUTTON);  // short press B tidak dipakai di mode ini
+  }
+  
   if (buttons.isButtonBLongPress()) {
     exitProgrammingMode();
   }
@@ -110,6 +136,8 @@ void SystemManager::switchRegister() {
   
   if (currentMode == MODE_NORMAL && isPlaying) {
     loadCurrentSound();
+  } else {
+    latencyProbe.cancel(LAT_BUTTON);  // tidak ada suara yang berubah
   }
 }
 
@@ -118,16 +146,25 @@ void SystemManager::togglePlayback() {
   
   if (isPlaying) {
     leds.setRegister(currentRegister);
+    crankPending = true;  // suara start diputar begitu register siap
     loadCurrentSound();
     Serial.println("▶️ Play");
   } else {
     leds.setAllOff();
-    if (player) player->stopPlayback();
+    crankPending = false;
+    if (player && effectMixer.trigger(EFFECT_STOP)) {
+      player->stopEngine();
+      stopPending = true;
+    } else if (player) {
+      player->stopPlayback();
+    }
+    latencyProbe.applied(LAT_BUTTON);
     Serial.println("⏸️ Stop");
   }
 }
 
 void SystemManager::enterProgrammingMode() {
+  latencyProbe.cancel(LAT_BUTTON);  // long press tidak diukur
   currentMode = MODE_PROGRAMMING;
   leds.setBlinkMode(true);
   ble.enableFileTransfer(true);
@@ -140,6 +177,7 @@ void SystemManager::enterProgrammingMode() {
 }
 
 void SystemManager::exitProgrammingMode() {
+  latencyProbe.cancel(LAT_BUTTON);
   currentMode = MODE_NORMAL;
   leds.setBlinkMode(false);
   leds.setRegister(currentRegister);
@@ -149,6 +187,13 @@ void SystemManager::exitProgrammingMode() {
   // Unmute audio when exiting programming mode
   volumeControl.mute(false);
   
+  // Register yang file-nya berubah di-load ulang ke cache; register aktif
+  // diaktifkan lagi supaya file baru langsung terdengar
+  preloadSounds();
+  if (isPlaying) {
+    loadCurrentSound();
+  }
+  
   Serial.println("🎮 Normal Mode - Audio restored");
 }
 
@@ -159,6 +204,7 @@ void SystemManager::handleBLECommands() {
   uint8_t* data = ble.getCommandData();
   
   Serial.printf("🔍 Processing BLE command: 0x%02X\n", cmd);
+  bool loadRequested = false;  // event latency ditutup di onSoundLoaded
   
   switch(cmd) {
     case CMD_GEAR_UP:
@@ -210,15 +256,26 @@ void SystemManager::handleBLECommands() {
         } else {
           // Start playing the selected register
           isPlaying = true;
+          crankPending = true;
           leds.setRegister(currentRegister);
           loadCurrentSound();
         }
+        loadRequested = true;
         Serial.printf("📱 BLE Set Audio Play: Register %d\n", currentRegister);
       }
       break;
       
     case CMD_TOGGLE_AUTO_SHIFT:
-      Serial.println("📱 Auto Shift (disabled)");
+      toggleAutoShift();
+      Serial.println("📱 BLE Toggle Auto Shift");
+      break;
+      
+    case CMD_RESET_DIAG:
+      latencyProbe.reset();
+#if AUDIO_PROFILER
+      audioProfiler.reset();
+#endif
+      Serial.println("📱 BLE Reset Diagnostics");
       break;
       
     case CMD_REQ_FILE_INFO:
@@ -270,6 +327,21 @@ void SystemManager::handleBLECommands() {
       break;
   }
   
+  // Latency BLE: command yang langsung mengubah suara selesai di sini
+  // (tinggal menunggu render), command lain tidak diukur
+  switch (cmd) {
+    case CMD_GEAR_UP:
+    case CMD_GEAR_DOWN:
+    case CMD_REV_START:
+    case CMD_REV_STOP:
+    case CMD_VOL:
+      latencyProbe.applied(LAT_BLE);
+      break;
+    default:
+      if (!loadRequested) latencyProbe.cancel(LAT_BLE);
+      break;
+  }
+  
   // Reset command data after processing
   ble.getCommandData()[0] = 0;
   // Note: commandDataLen will be reset on next command
@@ -292,26 +364,65 @@ void SystemManager::loadCurrentSound() {
     folderPath = "/Audio" + String(currentRegister - 1);
   }
   
-  // Find first .raw file in folder
-  String filename = "";
-  File dir = LittleFS.open(folderPath);
-  if (dir && dir.isDirectory()) {
-    File file = dir.openNextFile();
-    while (file) {
-      if (!file.isDirectory() && String(file.name()).endsWith(".raw")) {
-        filename = folderPath + "/" + file.name();
-        break;
-      }
-      file = dir.openNextFile();
-    }
-    dir.close();
-  }
+  // Semua .raw di folder jadi satu sound bank (grid RPM x load), di-load
+  // di AudioLoader task; hasilnya lewat onSoundLoaded
+  audioLoader.request(folderPath.c_str());
+}
+
+// Callback AudioLoader (jalan di loader task)
+void SystemManager::onSoundLoaded(const AudioLoadStatus &status) {
+  if (!instance) return;
   
-  if (filename != "" && player->loadFile(filename.c_str())) {
+  switch (status.state) {
+    case LOAD_PROGRESS:
+      Serial.printf("⏳ Loading %s: %d/%d\n", status.folder, status.loaded, status.total);
+      break;
+    case LOAD_DONE:
+      instance->loadDone = true;  // diproses di updateButtons (ADC task)
+      Serial.printf("✅ Loaded: %s\n", status.folder);
+      break;
+    case LOAD_FAILED:
+      latencyProbe.cancel(LAT_BUTTON);
+      latencyProbe.cancel(LAT_BLE);
+      Serial.printf("⚠️ File tidak ada di: %s\n", status.folder);
+      break;
+    case LOAD_CANCELLED:
+      Serial.printf("⏭️ Load dibatalkan: %s\n", status.folder);
+      break;
+  }
+}
+
+// Register hasil load sudah aktif: putar kalau masih mode play
+void SystemManager::startLoadedSound() {
+  if (isPlaying && currentMode == MODE_NORMAL) {
+    stopPending = false;
     player->startPlayback();
-    Serial.printf("✅ Loaded: %s\n", filename.c_str());
+    if (crankPending) {
+      crankPending = false;
+      effectMixer.trigger(EFFECT_START);
+    }
+    // Register baru terdengar: tutup event tombol/BLE yang memintanya
+    latencyProbe.applied(LAT_BUTTON);
+    latencyProbe.applied(LAT_BLE);
   } else {
-    Serial.printf("⚠️ File tidak ada di: %s\n", folderPath.c_str());
+    latencyProbe.cancel(LAT_BUTTON);
+    latencyProbe.cancel(LAT_BLE);
+  }
+}
+
+// Isi cache semua register yang muat (di background), supaya
+// switchRegister tanpa I/O
+void SystemManager::preloadSounds() {
+  if (!player) return;
+  
+  for (int reg = 1; reg <= 4; reg++) {
+    String folderPath;
+    if (reg == 1) {
+      folderPath = "/Audio";
+    } else {
+      folderPath = "/Audio" + String(reg - 1);
+    }
+    audioLoader.preload(folderPath.c_str());
   }
 }
 
@@ -347,6 +458,7 @@ void SystemManager::deleteCurrentRegisterFile() {
     }
     dir.close();
   }
+  soundCache.invalidate(folderPath.c_str());
   Serial.printf("✅ Register %d files deleted\n", currentRegister);
 }
 
@@ -378,109 +490,103 @@ void SystemManager::deleteAllFiles() {
       dir.close();
     }
   }
+  soundCache.invalidateAll();
   Serial.println("✅ All files deleted (folders preserved)");
 }
 
 void SystemManager::startRev() {
   if (!isRevving && player) {
     isRevving = true;
-    revStartTime = millis();
-    prevNormalRate = currentThrottleRate;  // Save current throttle position
-    Serial.printf("🔊 Rev start! T=%lu, From: %d Hz\n", revStartTime, prevNormalRate);
+#if !VEHICLE_MODEL_ENABLED
+    player->setEngineLoad(255);            // Rev = full on-throttle layer
+#endif
+    envelopes.trigger(ENV_REV_UP);
+    Serial.printf("🔊 Rev start! T=%lu, From: %lu Hz\n", millis(), currentThrottleRate);
   }
 }
 
 void SystemManager::stopRev() {
   if (isRevving) {
     isRevving = false;
-    isRevDown = true;
-    revDownStartTime = millis();
-    Serial.printf("⛔ Rev down start: %d -> %d Hz\n", revTargetRate, prevNormalRate);
-  }
-}
-
-void SystemManager::triggerShift() {
-  if (!isShifting && !isRevving && player) {
-    shiftBaseRate = currentThrottleRate;
-    shiftTargetRate = (uint32_t)(currentThrottleRate * 1.3f);  // 130% dari rate saat ini (gear up)
-    shiftStartTime = millis();
-    isShifting = true;
-    shiftPhase = 0;  // Reset phase
-    Serial.printf("⚙️ Gear shift start! %d -> %d Hz (30%% up)\n", shiftBaseRate, shiftTargetRate);
+#if !VEHICLE_MODEL_ENABLED
+    if (player) player->setEngineLoad(0);  // Turun = off-throttle (decel) layer
+#endif
+    envelopes.trigger(ENV_REV_DOWN);
+    if (isPlaying) effectMixer.trigger(EFFECT_POP);  // overrun pops
+    Serial.printf("⛔ Rev down start -> %lu Hz\n", currentThrottleRate);
   }
 }
 
+// Shift boleh di tengah rev atau shift lain: envelope shift menyambung
+// dari level sekarang dan ditumpuk di atas rev
 void SystemManager::triggerGearUp() {
-  if (currentGear < maxGear && !isShifting && !isRevving) {
-    currentGear++;
-    triggerShift();
-    Serial.printf("⬆️ Gear UP -> %d\n", currentGear);
-  } else if (currentGear >= maxGear) {
-    Serial.printf("⚠️ Max gear (%d)\n", maxGear);
+  uint8_t gear = vehicle.getGear();
+  if (gear < vehicle.getGearCount()) {
+    shiftTo(gear + 1, false);
+  } else {
+    Serial.printf("⚠️ Max gear (%d)\n", vehicle.getGearCount());
   }
 }
 
 void SystemManager::triggerGearDown() {
-  if (currentGear > 1 && !isShifting && !isRevving) {
-    currentGear--;
-    triggerShift();
-    Serial.printf("⬇️ Gear DOWN -> %d\n", currentGear);
-  } else if (currentGear <= 1) {
+  uint8_t gear = vehicle.getGear();
+  if (gear > 1) {
+    shiftTo(gear - 1, false);
+  } else {
     Serial.println("⚠️ Min gear (1)");
   }
 }
 
-void SystemManager::updateRev() {
-  if (!player) return;
-  
-  if (isRevving) {
-    unsigned long elapsed = millis() - revStartTime;
-    if (elapsed >= revRampDuration) {
-      player->setSampleRate(revTargetRate);
-    } else {
-      float progress = (float)elapsed / revRampDuration;
-      uint32_t newRate = prevNormalRate + (revTargetRate - prevNormalRate) * progress;
-      player->setSampleRate(newRate);
-    }
-  } else if (isRevDown) {
-    unsigned long elapsed = millis() - revDownStartTime;
-    if (elapsed < revDownDuration) {
-      float progress = (float)elapsed / revDownDuration;
-      uint32_t blendedRate = revTargetRate - (revTargetRate - prevNormalRate) * progress;
-      player->setSampleRate(blendedRate);
-    } else {
-      player->setSampleRate(prevNormalRate);
-      isRevDown = false;
-      Serial.println("✅ Turun selesai, balik idle");
-    }
-  }
+// Jalur shift bersama manual dan auto: envelope, efek, dan dwell auto
+// shift (shift manual saat auto ON = override sementara)
+void SystemManager::shiftTo(uint8_t gear, bool automatic) {
+  uint8_t from = vehicle.getGear();
+  if (gear == from) return;
+  bool up = gear > from;
+  vehicle.shift(gear);
+  autoShift.noteShift(millis());
+  envelopes.trigger(up ? ENV_SHIFT_UP : ENV_SHIFT_DOWN);
+  if (isPlaying) effectMixer.trigger(up ? EFFECT_SHIFT_UP : EFFECT_SHIFT_DOWN);
+  Serial.printf("%s Gear %s -> %d%s\n", up ? "⬆️" : "⬇️", up ? "UP" : "DOWN", gear,
+                automatic ? " (auto)" : "");
 }
 
-void SystemManager::updateShift() {
-  if (!player || !isShifting) return;
-  
-  unsigned long elapsed = millis() - shiftStartTime;
-  uint32_t newRate = shiftBaseRate;
-  
-  if (shiftPhase == 0) {  // Rise to target (150ms)
-    if (elapsed < 150) {
-      float progress = (float)elapsed / 150.0f;
-      newRate = shiftBaseRate + (shiftTargetRate - shiftBaseRate) * progress;
-    } else {
-      shiftPhase = 1;
-      shiftStartTime = millis();
-      newRate = shiftTargetRate;
-    }
-  } else if (shiftPhase == 1) {  // Recovery to base rate (200ms)
-    if (elapsed < 200) {
-      float progress = (float)elapsed / 200.0f;
-      newRate = shiftTargetRate - (shiftTargetRate - shiftBaseRate) * progress;
-    } else {
-      isShifting = false;
-      newRate = shiftBaseRate;  // Kembali ke rate awal
-      Serial.println("✅ Shift complete");
-    }
+void SystemManager::toggleAutoShift() {
+#if VEHICLE_MODEL_ENABLED
+  autoShift.setEnabled(!autoShift.isEnabled());
+  // Dari netral langsung masuk gigi 1
+  if (autoShift.isEnabled() && vehicle.getGear() == 0) shiftTo(1, true);
+#else
+  Serial.println("⚠️ Auto shift butuh VEHICLE_MODEL_ENABLED");
+#endif
+}
+
+// Dipanggil dari ADC task tiap loop. Dengan VehicleModel: envelope rev
+// jadi override gas, model maju per step tetap dan pitch/load mengikuti
+// RPM dan gas efektif (drop RPM saat shift datang dari slip kopling, jadi
+// envelope shift tidak ditumpuk ke pitch). Tanpa model: envelope maju per
+// tick tetap dan rate diterapkan selama ada envelope aktif (termasuk tick
+// terakhirnya); saat idle throttle mengatur rate langsung (lihat ADCTask).
+void SystemManager::updateDrive() {
+  if (!player) return;
+
+#if VEHICLE_MODEL_ENABLED
+  uint8_t autoGear = autoShift.update(millis());
+  if (autoGear) shiftTo(autoGear, true);
+
+  envelopes.update(millis());
+  vehicle.setThrottleOverride(envelopes.getLevel(ENV_CH_REV));
+  if (vehicle.update(micros())) {
+    player->setEngineRPM(vehicle.getRPM());
+    player->setEngineLoad(vehicle.getLoad());
   }
-  
-  player->setSampleRate(newRate);
+#else
+  if (envelopes.update(millis())) {
+    player->setSampleRate(envelopes.apply(currentThrottleRate, revTargetRate));
+  }
+#endif
+
+  bool busy = envelopes.isBusy();
+  if (envelopeWasBusy && !busy) Serial.println("✅ Envelope selesai, balik ke throttle");
+  envelopeWasBusy = busy;
 }
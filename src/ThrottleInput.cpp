@@ -0,0 +1,146 @@
+#include "ThrottleInput.h"
+#include <driver/adc.h>
+
+ThrottleInput throttleInput;
+
+#define ONE_EURO_TWO_PI 6.2831853f
+
+// alpha low-pass orde 1 untuk cutoff fc di sample rate fs
+static float lowPassAlpha(float fc, float fs) {
+  return 1.0f / (1.0f + fs / (ONE_EURO_TWO_PI * fc));
+}
+
+bool ThrottleInput::begin() {
+  // Kurva kalibrasi dari eFuse (two-point / Vref), fallback Vref 1100 mV
+  esp_adc_cal_value_t source = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11,
+                                                        ADC_WIDTH_BIT_12, 1100, &cal);
+  const char *calName = source == ESP_ADC_CAL_VAL_EFUSE_TP ? "eFuse two-point"
+                      : source == ESP_ADC_CAL_VAL_EFUSE_VREF ? "eFuse Vref" : "default Vref";
+
+  int8_t channel = digitalPinToAnalogChannel(THROTTLE_ADC_PIN);
+#if AUDIO_OUTPUT_BACKEND == AUDIO_BACKEND_I2S
+  dma = false;  // I2S0 dipakai DAC
+#else
+  dma = channel >= 0 && channel < 8 && startDma(channel);  // DMA hanya ADC1
+#endif
+  outputRate = dma ? THROTTLE_ADC_RATE / THROTTLE_OVERSAMPLE : 1000;
+  slopeAlpha = lowPassAlpha(THROTTLE_DCUTOFF_HZ, outputRate);
+
+  BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "Throttle", 3072, (void *)(intptr_t)channel,
+                                          THROTTLE_TASK_PRIORITY, nullptr, THROTTLE_TASK_CORE);
+  if (ok != pdPASS) {
+    Serial.println("❌ Throttle task gagal dibuat");
+    return false;
+  }
+  Serial.printf("✅ Throttle: %s %lu Hz (x%d), kalibrasi %s\n", dma ? "ADC DMA" : "polling",
+                outputRate, dma ? THROTTLE_OVERSAMPLE : THROTTLE_POLL_OVERSAMPLE, calName);
+  return true;
+}
+
+bool ThrottleInput::startDma(int8_t channel) {
+  adc_digi_init_config_t init = {};
+  init.max_store_buf_size = THROTTLE_DMA_FRAME * SOC_ADC_DIGI_RESULT_BYTES * 4;
+  init.conv_num_each_intr = THROTTLE_DMA_FRAME * SOC_ADC_DIGI_RESULT_BYTES;
+  init.adc1_chan_mask = 1 << channel;
+  init.adc2_chan_mask = 0;
+  if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+  adc_digi_pattern_config_t pattern = {};
+  pattern.atten = ADC_ATTEN_DB_11;
+  pattern.channel = channel;
+  pattern.unit = 0;  // ADC1
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+  adc_digi_configuration_t config = {};
+  config.conv_limit_en = 1;  // wajib di ESP32
+  config.conv_limit_num = 250;
+  config.pattern_num = 1;
+  config.adc_pattern = &pattern;
+  config.sample_freq_hz = THROTTLE_ADC_RATE;
+  config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+  if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+    adc_digi_deinitialize();
+    return false;
+  }
+  return true;
+}
+
+void ThrottleInput::taskEntry(void *param) {
+  int8_t channel = (int8_t)(intptr_t)param;
+  if (throttleInput.dma) throttleInput.runDma(channel);
+  else throttleInput.runPolled();
+}
+
+// Frame DMA -> blok THROTTLE_OVERSAMPLE konversi. Konversi channel lain
+// (glitch DMA ESP32) dibuang.
+void ThrottleInput::runDma(int8_t channel) {
+  static adc_digi_output_data_t frame[THROTTLE_DMA_FRAME];
+  uint32_t sum = 0, count = 0;
+
+  for (;;) {
+    uint32_t bytes = 0;
+    esp_err_t err = adc_digi_read_bytes((uint8_t *)frame, sizeof(frame), &bytes, 100);
+    if (err != ESP_OK) continue;  // timeout / overflow: lanjut frame berikutnya
+
+    uint32_t n = bytes / SOC_ADC_DIGI_RESULT_BYTES;
+    for (uint32_t i = 0; i < n; i++) {
+      if (frame[i].type1.channel != channel) continue;
+      sum += frame[i].type1.data;
+      if (++count == THROTTLE_OVERSAMPLE) {
+        push(linearize(sum, count));
+        sum = 0;
+        count = 0;
+      }
+    }
+  }
+}
+
+// Fallback tanpa DMA: oversampling kecil tiap 1 ms
+void ThrottleInput::runPolled() {
+  for (;;) {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < THROTTLE_POLL_OVERSAMPLE; i++) sum += analogRead(THROTTLE_ADC_PIN);
+    push(linearize(sum, THROTTLE_POLL_OVERSAMPLE));
+    vTaskDelay(1 / portTICK_PERIOD_MS);
+  }
+}
+
+// Rata-rata raw (Q4) -> mV lewat kurva kalibrasi (interpolasi antar kode)
+// -> 0-4095 di jendela THROTTLE_MV_MIN..MAX
+uint16_t ThrottleInput::linearize(uint32_t sum, uint32_t count) {
+  uint32_t q4 = (sum << 4) / count;
+  uint32_t code = q4 >> 4;
+  uint32_t frac = q4 & 15;
+  int32_t mv = esp_adc_cal_raw_to_voltage(code, &cal);
+  int32_t mvQ4 = mv << 4;
+  if (frac && code < 4095) {
+    mvQ4 += ((int32_t)esp_adc_cal_raw_to_voltage(code + 1, &cal) - mv) * (int32_t)frac;
+  }
+
+  int32_t t = (mvQ4 - (THROTTLE_MV_MIN << 4)) * 4095 / ((THROTTLE_MV_MAX - THROTTLE_MV_MIN) << 4);
+  if (t < 0) t = 0;
+  if (t > 4095) t = 4095;
+  return (uint16_t)t;
+}
+
+// One-euro filter (Casiez dkk.): cutoff = min + beta * |kecepatan|
+void ThrottleInput::push(uint16_t input) {
+  float x = input;
+  if (!primed) {
+    value = prevInput = x;
+    primed = true;
+  }
+
+  float speed = (x - prevInput) * outputRate;
+  prevInput = x;
+  slope += slopeAlpha * (speed - slope);
+
+  float cutoff = THROTTLE_MIN_CUTOFF_HZ + THROTTLE_BETA * fabsf(slope);
+  value += lowPassAlpha(cutoff, outputRate) * (x - value);
+
+  uint32_t out = (uint32_t)(value + 0.5f);
+  if (out > 4095) out = 4095;
+  published = out | ((uint32_t)input << 16);
+}
@@ -0,0 +1,140 @@
+#include "TimerDacSink.h"
+#include "AudioProfiler.h"
+
+hw_timer_t *TimerDacSink::timer = nullptr;
+uint8_t TimerDacSink::blocks[2][AUDIO_BLOCK_SAMPLES];
+volatile bool TimerDacSink::blockReady[2] = {false, false};
+volatile uint8_t TimerDacSink::playingBlock = 0;
+uint16_t TimerDacSink::readPos = 0;
+uint8_t TimerDacSink::lastSample = 128;
+volatile uint32_t TimerDacSink::underruns = 0;
+TaskHandle_t TimerDacSink::renderTaskHandle = nullptr;
+
+// ISR timer: pop 1 sample dari blok yang sedang diputar, tanpa proses apapun.
+// Blok kosong (render telat) = tahan sample terakhir, bukan lompat ke 128.
+void IRAM_ATTR TimerDacSink::onTimerISR() {
+  AUDIO_PROFILE_ISR_BEGIN();
+  uint8_t b = playingBlock;
+  if (!blockReady[b]) {
+    underruns++;
+    dacWrite(AUDIO_DAC_PIN, lastSample);
+    AUDIO_PROFILE_ISR_END();
+    return;
+  }
+
+  lastSample = blocks[b][readPos];
+  dacWrite(AUDIO_DAC_PIN, lastSample);
+
+  if (++readPos >= AUDIO_BLOCK_SAMPLES) {
+    readPos = 0;
+    blockReady[b] = false;   // kembalikan blok ke render task
+    playingBlock = b ^ 1;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(renderTaskHandle, &woken);
+    AUDIO_PROFILE_ISR_END();
+    if (woken) portYIELD_FROM_ISR();
+    return;
+  }
+  AUDIO_PROFILE_ISR_END();
+}
+
+// Timer tick 1MHz (prescaler 80), periode = 1000000 / sampleRate us
+bool TimerDacSink::begin(uint32_t sampleRate, AudioRenderFn render) {
+  if (sampleRate == 0 || 1000000 % sampleRate != 0) {
+    Serial.printf("❌ Timer sink: rate %lu Hz tidak membagi 1MHz\n", sampleRate);
+    return false;
+  }
+
+  rate = sampleRate;
+  renderFn = render;
+  dacWrite(AUDIO_DAC_PIN, 128);  // idle mid
+
+  memset(blocks, 128, sizeof(blocks));
+  blockReady[0] = false;
+  blockReady[1] = false;
+  playingBlock = 0;
+  readPos = 0;
+  underruns = 0;
+
+  renderMutex = xSemaphoreCreateMutex();
+  running = true;
+
+  xTaskCreatePinnedToCore(
+    renderTaskWrapper,
+    "AudioRender",
+    4096,
+    this,
+    AUDIO_TASK_PRIORITY,
+    &renderTaskHandle,
+    AUDIO_TASK_CORE
+  );
+
+  timer = timerBegin(0, 80, true);
+  timerAttachInterrupt(timer, &TimerDacSink::onTimerISR, true);
+  timerAlarmWrite(timer, 1000000 / sampleRate, true);
+  timerAlarmEnable(timer);
+
+  Serial.printf("✅ Audio output: timer ISR @ %lu Hz (2 x %d sample)\n",
+                rate, AUDIO_BLOCK_SAMPLES);
+  return true;
+}
+
+void TimerDacSink::end() {
+  if (timer) {
+    timerAlarmDisable(timer);
+    timerEnd(timer);
+    timer = nullptr;
+  }
+  running = false;
+  pause();
+  if (renderTaskHandle) {
+    vTaskDelete(renderTaskHandle);
+    renderTaskHandle = nullptr;
+  }
+  dacWrite(AUDIO_DAC_PIN, 128);
+}
+
+// Tunggu blok yang sedang dirender selesai, blok berikutnya silence.
+// Timer tetap jalan: blok yang sudah siap hanya berisi salinan sample,
+// tidak menunjuk ke buffer audio yang akan di-free.
+void TimerDacSink::pause() {
+  paused = true;
+  if (renderMutex) {
+    xSemaphoreTake(renderMutex, portMAX_DELAY);
+    xSemaphoreGive(renderMutex);
+  }
+}
+
+void TimerDacSink::resume() {
+  paused = false;
+}
+
+void TimerDacSink::renderTaskWrapper(void *parameter) {
+  static_cast<TimerDacSink *>(parameter)->renderTask();
+}
+
+// Isi setiap blok yang sudah dikembalikan ISR. Timeout 10ms hanya jaga-jaga
+// kalau notify terlewat; normalnya task bangun sekali per blok.
+void TimerDacSink::renderTask() {
+  while (running) {
+    for (uint8_t b = 0; b < 2; b++) {
+      if (blockReady[b]) continue;
+
+      xSemaphoreTake(renderMutex, portMAX_DELAY);
+      if (paused || !renderFn) {
+        memset(blocks[b], 128, AUDIO_BLOCK_SAMPLES);
+      } else {
+        AUDIO_PROFILE_RENDER_BEGIN();
+        renderFn(blocks[b], AUDIO_BLOCK_SAMPLES);
+        AUDIO_PROFILE_RENDER_END();
+      }
+      xSemaphoreGive(renderMutex);
+
+      __sync_synchronize();  // isi blok harus terlihat sebelum flag
+      blockReady[b] = true;
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+  }
+  vTaskDelete(nullptr);
+}
@@ -0,0 +1,255 @@
+#include "VehicleModel.h"
+
+VehicleModel vehicle;
+
+static const float STEP_SEC = VEHICLE_STEP_US / 1000000.0f;
+
+// Torsi relatif terhadap revRate. Gas penuh di netral seimbang jauh di
+// atas limiter (1.3 * kurva vs rugi x), jadi free rev gas penuh selalu
+// kena limiter dan gas parsial berhenti di RPM yang kira-kira sebanding.
+#define TORQUE_GAIN       1.3f
+#define IDLE_GAIN         8.0f     // idle governor di bawah idleRPM
+#define CLUTCH_CAP_GAIN   2.0f     // kapasitas kopling x revRate
+#define LAUNCH_RANGE      0.15f    // kopling sentrifugal penuh di idle + 15% rentang
+#define ROLL_DRAG         0.01f    // hambatan rolling x revRate
+#define AERO_DRAG         0.09f    // hambatan aero x revRate di topRPM (gigi teratas)
+#define BLIP_THROTTLE     0.35f    // blip downshift saat kopling terbuka
+#define LIMIT_HYST        0.02f    // histeresis limiter x rentang RPM
+
+VehicleModel::VehicleModel() {
+  defaultParams(p);
+  pending = p;
+  applyParams();
+  rpm = p.idleRPM;
+}
+
+// Nilai bawaan untuk aset tanpa field drivetrain; rentang RPM mengikuti
+// default AudioMeta
+void VehicleModel::defaultParams(VehicleParams &params) {
+  memset(&params, 0, sizeof(params));
+  params.idleRPM = 500;
+  params.topRPM = 15000;
+  params.limitRPM = 15000;
+  params.gearCount = 4;
+}
+
+// "3.0,2.1,1.6,1.25" (gigi 1 dulu). Dinormalisasi ke gigi teratas saat
+// applyParams, jadi rasio absolut (termasuk final drive) juga boleh.
+bool VehicleModel::parseRatios(const char *text, VehicleParams &out) {
+  float ratios[VEHICLE_MAX_GEARS];
+  uint8_t count = 0;
+  const char *s = text;
+
+  while (*s) {
+    if (count >= VEHICLE_MAX_GEARS) return false;
+    char *end;
+    float r = strtof(s, &end);
+    if (end == s || r <= 0.0f || r > 50.0f) return false;
+    if (count > 0 && r > ratios[count - 1]) return false;  // harus turun
+    ratios[count++] = r;
+    s = end;
+    if (*s == ',') s++;
+    else if (*s) return false;
+  }
+
+  if (count == 0) return false;
+  memcpy(out.ratios, ratios, sizeof(ratios[0]) * count);
+  out.gearCount = count;
+  return true;
+}
+
+// Dipanggil dari task loader/BLE saat register aktif ganti; diterapkan di
+// step berikutnya (RPM dan kecepatan tetap, gigi di-clamp)
+void VehicleModel::setParams(const VehicleParams &params) {
+  portENTER_CRITICAL(&mux);
+  pending = params;
+  paramsPending = true;
+  uint8_t n = params.gearCount ? params.gearCount : 1;
+  if (n > VEHICLE_MAX_GEARS) n = VEHICLE_MAX_GEARS;
+  gearCount = n;
+  if (requestedGear > n) requestedGear = n;
+  portEXIT_CRITICAL(&mux);
+}
+
+// Lengkapi field 0 dengan bawaan dan hitung konstanta turunan
+void VehicleModel::applyParams() {
+  if (p.idleRPM == 0) p.idleRPM = 500;
+  if (p.topRPM <= p.idleRPM) p.topRPM = p.idleRPM + 1000;
+  if (p.limitRPM == 0 || p.limitRPM > p.topRPM) p.limitRPM = p.topRPM;
+  if (p.limitRPM <= p.idleRPM) p.limitRPM = p.topRPM;
+  if (p.gearCount == 0) p.gearCount = 1;
+  if (p.gearCount > VEHICLE_MAX_GEARS) p.gearCount = VEHICLE_MAX_GEARS;
+  range = p.topRPM - p.idleRPM;
+
+  // Rasio bawaan: deret geometris 3.0 (gigi 1) sampai 1.0 (gigi teratas)
+  uint8_t n = p.gearCount;
+  if (p.ratios[0] <= 0.0f) {
+    for (uint8_t i = 0; i < n; i++) {
+      p.ratios[i] = n > 1 ? powf(3.0f, (float)(n - 1 - i) / (n - 1)) : 1.0f;
+    }
+  }
+  float top = p.ratios[n - 1];
+  for (uint8_t i = 0; i < n; i++) {
+    p.ratios[i] /= top;
+    ratioPermil[i] = (uint16_t)(p.ratios[i] * 1000.0f + 0.5f);
+  }
+
+  if (p.revRate <= 0.0f) p.revRate = range * 1.5f;
+  if (p.engineBrake <= 0.0f) p.engineBrake = p.revRate * 0.6f;
+  if (p.inertia <= 0.0f) p.inertia = 12.0f;
+  if (p.shiftMs == 0) p.shiftMs = 120;
+  if (p.clutchMs == 0) p.clutchMs = 150;
+
+  // Slip meluruh dengan laju K * (1 + r^2 / I); setengah batas stabil
+  // Euler di rasio terbesar supaya kopling terkunci tanpa osilasi
+  float r0 = p.ratios[0];
+  clutchK = 0.5f / (STEP_SEC * (1.0f + r0 * r0 / p.inertia));
+  clutchCap = CLUTCH_CAP_GAIN * p.revRate;
+  paramsVersion++;
+}
+
+void VehicleModel::setThrottle(uint16_t raw) {
+  throttleRaw = raw > 4095 ? 4095 : raw;
+}
+
+void VehicleModel::setThrottleOverride(int32_t permil) {
+  overridePermil = permil;
+}
+
+uint16_t VehicleModel::getThrottle() {
+  int32_t over = overridePermil * 4095 / 1000;
+  uint16_t thr = throttleRaw;
+  if (over > thr) thr = over > 4095 ? 4095 : over;
+  return thr;
+}
+
+uint16_t VehicleModel::getRatioPermil(uint8_t gear) {
+  if (gear == 0 || gear > p.gearCount) return 0;
+  return ratioPermil[gear - 1];
+}
+
+// 0 = netral, 1..gearCount. Gigi diterapkan di step berikutnya.
+void VehicleModel::shift(uint8_t target) {
+  portENTER_CRITICAL(&mux);
+  requestedGear = target > gearCount ? gearCount : target;
+  portEXIT_CRITICAL(&mux);
+}
+
+// Kurva torsi: puncak di 70% rentang, 70% di idle, ~95% di top
+float VehicleModel::torqueShape(float x) {
+  float d = x - 0.7f;
+  float shape = 1.0f - 0.3f * d * d / 0.49f;
+  return shape < 0.5f ? 0.5f : shape;
+}
+
+void VehicleModel::step() {
+  // ===== Input =====
+  portENTER_CRITICAL(&mux);
+  bool reload = paramsPending;
+  if (reload) {
+    p = pending;
+    paramsPending = false;
+  }
+  uint8_t target = requestedGear;
+  portEXIT_CRITICAL(&mux);
+  if (reload) applyParams();
+
+  if (target != gear) {
+    upshift = target > gear;
+    gear = target;
+    // Ke netral cukup lepas; masuk gigi: buka kopling lalu sambung lagi
+    shiftPhase = gear == 0 ? SHIFT_IDLE : SHIFT_OPEN;
+    shiftLeft = (uint32_t)p.shiftMs * 1000 / VEHICLE_STEP_US;
+    clutch = gear == 0 ? Q16_ONE : 0;
+  }
+
+  float thr = throttleRaw / 4095.0f;
+  float over = overridePermil / 1000.0f;
+  if (over > thr) thr = over;
+  if (thr > 1.0f) thr = 1.0f;
+  if (thr < 0.0f) thr = 0.0f;
+
+  // ===== Sequencer shift =====
+  if (shiftPhase == SHIFT_OPEN) {
+    clutch = 0;
+    if (upshift) thr = 0.0f;                        // ignition cut
+    else if (thr < BLIP_THROTTLE) thr = BLIP_THROTTLE;  // rev-match blip
+    if (shiftLeft == 0 || --shiftLeft == 0) {
+      shiftPhase = SHIFT_ENGAGE;
+      shiftLeft = (uint32_t)p.clutchMs * 1000 / VEHICLE_STEP_US;
+    }
+  } else if (shiftPhase == SHIFT_ENGAGE) {
+    uint32_t total = (uint32_t)p.clutchMs * 1000 / VEHICLE_STEP_US;
+    if (shiftLeft == 0 || --shiftLeft == 0) {
+      shiftPhase = SHIFT_IDLE;
+      clutch = Q16_ONE;
+    } else {
+      clutch = easeQ16(EASE_SMOOTH, q16Ratio(total - shiftLeft, total));
+    }
+  }
+
+  // ===== Rev limiter (fuel cut dengan histeresis) =====
+  if (rpm >= p.limitRPM) limiterCut = true;
+  else if (limiterCut && rpm < p.limitRPM - range * LIMIT_HYST) limiterCut = false;
+  if (limiterCut) thr = 0.0f;
+  throttleEff = thr;
+
+  // ===== Engine =====
+  float x = (rpm - p.idleRPM) / range;
+  float brake = p.engineBrake / p.revRate;
+  float te = thr * TORQUE_GAIN * torqueShape(x);
+  if (x > 0.0f) te -= x * (thr + (1.0f - thr) * brake);  // rugi pompa / engine brake
+  else te -= x * IDLE_GAIN;                                // idle governor
+  te *= p.revRate;
+
+  // ===== Kopling =====
+  float tc = 0.0f;
+  float ratio = 0.0f;
+  if (gear > 0) {
+    ratio = p.ratios[gear - 1];
+    float launch = x / LAUNCH_RANGE;
+    if (launch > 1.0f) launch = 1.0f;
+    if (launch < 0.0f) launch = 0.0f;
+    float cap = clutchCap * launch * clutch * (1.0f / Q16_ONE);
+    tc = clutchK * (rpm - driveRPM * ratio);
+    if (tc > cap) tc = cap;
+    if (tc < -cap) tc = -cap;
+  }
+
+  // ===== Integrasi (Euler, step tetap) =====
+  rpm += (te - tc) * STEP_SEC;
+  if (rpm < 0.0f) rpm = 0.0f;
+
+  float v = driveRPM / p.topRPM;
+  float drag = driveRPM > 0.0f ? p.revRate * (ROLL_DRAG + AERO_DRAG * v * v) : 0.0f;
+  driveRPM += (tc * ratio - drag) / p.inertia * STEP_SEC;
+  if (driveRPM < 0.0f) driveRPM = 0.0f;
+}
+
+// Dipanggil dari task kontrol; maju per step tetap sebanyak waktu yang
+// lewat (dikejar maks VEHICLE_MAX_CATCHUP step), lalu publish output
+bool VehicleModel::update(uint32_t nowUs) {
+  if (!started) {
+    lastStep = nowUs;
+    started = true;
+    return false;
+  }
+
+  uint32_t behind = nowUs - lastStep;
+  if (behind > VEHICLE_MAX_CATCHUP * VEHICLE_STEP_US) {
+    lastStep = nowUs - VEHICLE_MAX_CATCHUP * VEHICLE_STEP_US;
+  }
+  while (nowUs - lastStep >= VEHICLE_STEP_US) {
+    lastStep += VEHICLE_STEP_US;
+    step();
+  }
+
+  // RPM langsung ke player (pitch = rpm / sample_engine_rpm per rekaman)
+  uint32_t rpmOut = (uint32_t)(rpm + 0.5f);
+  uint8_t load = (uint8_t)(throttleEff * 255.0f + 0.5f);
+
+  bool changed = rpmOut != publishedRPM || load != publishedLoad;
+  publishedRPM = rpmOut;
+  publishedLoad = load;
+  return changed;
+}
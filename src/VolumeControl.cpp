@@ -2,28 +2,41 @@
 
 VolumeControl volumeControl;
 
-VolumeControl::VolumeControl() {}
+VolumeControl::VolumeControl() {
+  state.targetGain = 0;
+  state.rampSamples = 0;
+}
 
 void VolumeControl::begin() {
-  buildVolumeLUT();
+  publish(VOLUME_FADE_MS);  // fade in dari diam
   Serial.println("✅ Volume Control initialized");
 }
 
+// Seqlock: nomor urut ganjil selama state ditulis. Mux hanya menserialkan
+// penulis (BLE task vs ADC task); render tidak pernah lock.
+void VolumeControl::publish(uint32_t rampMs) {
+  portENTER_CRITICAL(&stateMux);
+  stateSeq = stateSeq + 1;
+  __sync_synchronize();
+  state.targetGain = muted ? 0 : (int32_t)currentVolume * VOLUME_UNITY / 100;
+  state.rampSamples = rampMs * AUDIO_OUTPUT_RATE / 1000;
+  __sync_synchronize();
+  stateSeq = stateSeq + 1;
+  portEXIT_CRITICAL(&stateMux);
+}
+
+// Full scale tanpa cap: puncak dijaga limiter di processBlock
 void VolumeControl::setVolume(uint8_t level) {
   if (level > 100) level = 100;
-  
+
   currentVolume = level;
-  volumeMultiplier = level / 100.0f;
-  
-  // Anti clipping - max 90%
-  if (volumeMultiplier > 0.9f) volumeMultiplier = 0.9f;
-  
-  buildVolumeLUT();
+  publish(VOLUME_RAMP_MS);
   Serial.printf("🔊 Volume: %d%%\n", level);
 }
 
 void VolumeControl::mute(bool enable) {
   muted = enable;
+  publish(VOLUME_FADE_MS);
   Serial.printf("🔇 Mute: %s\n", muted ? "ON" : "OFF");
 }
 
@@ -31,15 +44,112 @@ void VolumeControl::toggleMute() {
   mute(!muted);
 }
 
-void VolumeControl::buildVolumeLUT() {
-  for (int i = 0; i < 256; i++) {
-    int val = (int)(i * volumeMultiplier);
-    if (val > 255) val = 255;
-    volumeLUT[i] = (uint8_t)val;
-  }
+// Kurva soft knee: di bawah threshold T linear, di atasnya
+// o = T + K*(e-T) / ((e-T) + K) dengan K = ceiling - T. Slope 1 di T dan
+// mendekati ceiling secara asimtotik. Return gain Q15 = o / e.
+int32_t IRAM_ATTR VolumeControl::limiterGain(int32_t env) {
+  const int32_t T = VOLUME_LIMIT_THRESHOLD;
+  const int32_t K = VOLUME_LIMIT_CEILING - VOLUME_LIMIT_THRESHOLD;
+  if (env <= T) return VOLUME_UNITY;
+  int32_t over = env - T;
+  int32_t o = T + (K * over) / (over + K);
+  return (int32_t)(((int64_t)o << 15) / env);
 }
 
-uint8_t VolumeControl::processAudioSample(uint8_t sample) {
-  if (muted) return 128;  // Silent (center)
-  return volumeLUT[sample];
+// Per sub-blok VOLUME_LIMIT_BLOCK: puncak sub-blok (setelah gain volume)
+// masuk envelope (attack langsung, release eksponensial), gain limiter
+// dihitung sekali. Attack berlaku dari awal sub-blok, jadi puncak yang
+// sama tidak pernah lolos; release di-ramp linear di dalam sub-blok.
+//
+// Gain diterapkan di sekitar 0 (= DAC 128), jadi volume tidak menggeser DC.
+// Quantizer: u = x - e[n-1], y = Q(u + dither), e[n] = y - u, sehingga
+// noise kuantisasi keluar sebagai e[n] - e[n-1] (didorong ke frekuensi
+// tinggi, jauh dari band suara engine). Dither RPDF +-0.5 LSB 8-bit
+// mencegah idle tone saat sinyal kecil.
+void IRAM_ATTR VolumeControl::processBlock(const int16_t *in, uint8_t *out, size_t count) {
+  // State baru: salin sekali, ramp dari gain sekarang ke target. Sedang
+  // ditulis (ganjil) atau berubah saat disalin = coba lagi di blok berikut.
+  uint32_t seq = stateSeq;
+  if (seq != seenSeq && !(seq & 1)) {
+    __sync_synchronize();
+    int32_t gainCopy = state.targetGain;
+    uint32_t rampCopy = state.rampSamples;
+    __sync_synchronize();
+    if (stateSeq == seq) {
+      seenSeq = seq;
+      targetGain = gainCopy;
+      rampLeft = rampCopy ? rampCopy : 1;
+      rampStep = (targetGain - curGain) / (int32_t)rampLeft;
+    }
+  }
+
+  // Mute dan fade out sudah selesai
+  if (curGain == 0 && rampLeft == 0) {
+    memset(out, 128, count);  // Silent (center)
+    shapeErr = 0;
+    limitEnv = 0;
+    limitGain = VOLUME_UNITY;
+    return;
+  }
+
+  int32_t gain = curGain;
+  int32_t left = rampLeft;
+  int32_t err = shapeErr;
+  uint32_t seed = ditherSeed;
+
+  for (size_t base = 0; base < count; base += VOLUME_LIMIT_BLOCK) {
+    size_t n = count - base;
+    if (n > VOLUME_LIMIT_BLOCK) n = VOLUME_LIMIT_BLOCK;
+    const int16_t *src = in + base;
+
+    // Gain volume terbesar di sub-blok ini (awal atau akhir ramp)
+    int32_t gainEnd = ((uint32_t)left > n) ? gain + rampStep * (int32_t)n : targetGain;
+    int32_t gainMax = gain > gainEnd ? gain : gainEnd;
+
+    int32_t peak = 0;
+    for (size_t i = 0; i < n; i++) {
+      int32_t a = src[i] < 0 ? -(int32_t)src[i] : src[i];
+      if (a > peak) peak = a;
+    }
+    peak = (peak * gainMax) >> 15;
+
+    int32_t env = limitEnv - (limitEnv >> VOLUME_LIMIT_RELEASE_SHIFT);
+    if (peak > env) env = peak;
+    limitEnv = env;
+
+    int32_t lg = limiterGain(env);
+    if (lg < VOLUME_UNITY) limitedSamples += n;
+    int32_t lgCur = (lg < limitGain) ? lg : limitGain;
+    int32_t lgStep = (lg - lgCur) / (int32_t)n;
+    limitGain = lg;
+
+    for (size_t i = 0; i < n; i++) {
+      if (left > 0) {
+        gain += rampStep;
+        if (--left == 0) gain = targetGain;
+      }
+      int32_t g = (gain * lgCur) >> 15;
+      lgCur += lgStep;
+
+      int32_t u = (((int32_t)src[i] * g) >> 15) - err;
+
+      seed = seed * 1664525u + 1013904223u;
+      int32_t dither = (int32_t)(seed >> 24) - 128;
+
+      int32_t q = (u + dither + 128) >> 8;
+      if (q < -128) q = -128;
+      if (q > 127) q = 127;
+      out[base + i] = (uint8_t)(q + 128);
+
+      // Batasi error saat clipping supaya feedback tidak lari
+      err = q * 256 - u;
+      if (err > 512) err = 512;
+      else if (err < -512) err = -512;
+    }
+  }
+
+  curGain = gain;
+  rampLeft = left;
+  shapeErr = err;
+  ditherSeed = seed;
 }
@@ -4,6 +4,8 @@
 #include "AudioPlayer.h"
 #include "SystemManager.h"
 #include "OBD2Control.h"
+#include "LatencyProbe.h"
+#include "ThrottleInput.h"
 
 AudioPlayer player;
 SystemManager sysManager;
@@ -37,6 +39,7 @@ void setup() {
 
   player.begin();
   sysManager.begin(&player);
+  throttleInput.begin();
   
   // Initialize OBD2 system
   // obd2.begin();
@@ -70,48 +73,53 @@ void setup() {
 }
 
 // ADC + Button Task - Core 0
+// Akuisisi + filter throttle di ThrottleInput (task sendiri); di sini
+// hanya baca snapshot terakhir tiap loop.
 void ADCTask(void* parameter) {
-  static unsigned long lastUpdate = 0;
   static int lastRaw = 0;
-  static int smoothedRaw = 0;
-  
-  // Configurable ADC slope limiting
-  static int adcSlopeLimit = 200;
+  static uint32_t lastLog = 0;
+  static int eventRaw = 0;  // posisi throttle event latency terakhir
   
   for(;;) {
-    unsigned long now = millis();
-    
     // Handle buttons first (higher priority)
     sysManager.updateButtons();
     
-    // Throttle input update every 30ms for smoother response
-    if (now - lastUpdate >= 30) {
-      int raw = analogRead(THROTTLE_ADC_PIN);
-      
-      // Smooth the ADC reading with configurable slope limiting
-      int diff = raw - smoothedRaw;
-      if (abs(diff) > adcSlopeLimit) {
-        // Limit big jumps - apply slope
-        smoothedRaw += (diff > 0) ? adcSlopeLimit : -adcSlopeLimit;
-      } else {
-        smoothedRaw = raw;
-      }
-      
-      // Debug ADC values with smaller threshold
-      if (abs(smoothedRaw - lastRaw) > 10) {
-        uint32_t rate = map(smoothedRaw, 0, 4095, 8000, 44100);
-        Serial.printf("🎯 ADC: %d (smooth: %d) -> Rate: %d Hz\n", raw, smoothedRaw, rate);
-        lastRaw = smoothedRaw;
-      }
-      
-      // Use ADC as throttle input - back to 44.1kHz
-      uint32_t throttleRate = map(smoothedRaw, 0, 4095, 8000, 44100);
-      sysManager.setCurrentThrottleRate(throttleRate);
-      if (!sysManager.isRevActive() && !sysManager.isShiftActive()) {
-        player.updateSampleRateFromADC(smoothedRaw);
-      }
-      lastUpdate = now;
+    uint32_t snap = throttleInput.read();
+    int raw = ThrottleInput::raw(snap);
+    int throttle = ThrottleInput::filtered(snap);
+    
+    // Throttle bergerak = event latency baru, selesai saat nilai terfilter
+    // sampai ke posisi itu dan dikirim ke player
+    if (abs(raw - eventRaw) > LATENCY_ADC_DELTA) {
+      latencyProbe.stamp(LAT_ADC);
+      eventRaw = raw;
+    }
+    
+    // Debug ADC: throttle sekarang lolos tiap loop, jadi log dibatasi
+    // THROTTLE_LOG_MS supaya Serial tidak memblok task ini
+#if THROTTLE_LOG_MS > 0
+    if (abs(throttle - lastRaw) > 10 && millis() - lastLog >= THROTTLE_LOG_MS) {
+      lastLog = millis();
+      uint32_t rate = map(throttle, 0, 4095, 8000, 44100);
+      Serial.printf("🎯 ADC: %d (filter: %d) -> Rate: %d Hz\n", raw, throttle, rate);
+      lastRaw = throttle;
+    }
+#endif
+    
+    // Use ADC as throttle input - back to 44.1kHz
+    uint32_t throttleRate = map(throttle, 0, 4095, 8000, 44100);
+    sysManager.setCurrentThrottleRate(throttleRate);
+#if VEHICLE_MODEL_ENABLED
+    // Throttle = gas ke model; pitch/load diterapkan di updateDrive
+    sysManager.setThrottlePosition(throttle);
+    if (abs(throttle - eventRaw) <= LATENCY_ADC_DELTA) latencyProbe.applied(LAT_ADC);
+#else
+    if (!sysManager.isRevActive() && !sysManager.isShiftActive()) {
+      player.updateSampleRateFromADC(throttle);
+      player.setEngineLoad(throttle >> 4);  // posisi throttle -> load 0-255
+      if (abs(throttle - eventRaw) <= LATENCY_ADC_DELTA) latencyProbe.applied(LAT_ADC);
     }
+#endif
     
     vTaskDelay(5 / portTICK_PERIOD_MS);  // Reduced delay for better button response
   }
@@ -0,0 +1,126 @@
+// Konversi aset .raw PCM 8-bit ke IMA-ADPCM 4-bit sebelum upload.
+// Data dinormalisasi + dicari titik loopnya dulu (sama dengan proses di
+// device), lalu di-encode per blok. Header JSON lama (kalau ada) dipertahankan,
+// ditambah "format":"adpcm", "block", "normalized", "loop_start", "loop_end".
+//
+// Build & run dari root project:
+//   g++ -O2 -std=c++17 -Iinclude tools/adpcm_encode.cpp src/ImaAdpcm.cpp src/PCMNormalize.cpp src/LoopAnalyzer.cpp -o /tmp/adpcm_encode
+//   /tmp/adpcm_encode data/Audio/idle.raw /tmp/idle.raw [block=256]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "ImaAdpcm.h"
+#include "LoopAnalyzer.h"
+#include "PCMNormalize.h"
+
+// Header JSON datar ({"key":value,...}): ambil pasangan key/value mentah,
+// buang key yang akan ditulis ulang
+static std::string filterHeader(const std::string &header) {
+  static const char *dropped[] = {"format", "block", "normalized", "loop_start", "loop_end"};
+  std::string out;
+  size_t i = header.find('{');
+  if (i == std::string::npos) return out;
+  i++;
+
+  while (i < header.size()) {
+    while (i < header.size() && (header[i] == ' ' || header[i] == ',')) i++;
+    if (i >= header.size() || header[i] == '}') break;
+
+    // Satu pasangan sampai koma di luar string
+    size_t start = i;
+    bool inString = false;
+    for (; i < header.size(); i++) {
+      char c = header[i];
+      if (c == '"' && header[i - 1] != '\\') inString = !inString;
+      if (!inString && (c == ',' || c == '}')) break;
+    }
+    std::string pair = header.substr(start, i - start);
+
+    bool keep = true;
+    for (const char *key : dropped) {
+      if (pair.rfind(std::string("\"") + key + "\"", 0) == 0) keep = false;
+    }
+    if (keep) out += pair + ",";
+  }
+  return out;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s in.raw out.raw [block]\n", argv[0]);
+    return 2;
+  }
+  uint32_t blockBytes = argc > 3 ? (uint32_t)atoi(argv[3]) : 256;
+  if (blockBytes < 64 || blockBytes > 1024 || (blockBytes & (blockBytes - 1))) {
+    fprintf(stderr, "❌ block harus power of 2, 64-1024\n");
+    return 2;
+  }
+
+  FILE *in = fopen(argv[1], "rb");
+  if (!in) {
+    fprintf(stderr, "❌ Gagal buka %s\n", argv[1]);
+    return 1;
+  }
+  std::vector<uint8_t> file;
+  int c;
+  while ((c = fgetc(in)) != EOF) file.push_back((uint8_t)c);
+  fclose(in);
+
+  std::string header;
+  size_t dataOffset = 0;
+  if (!file.empty() && file[0] == '{') {
+    while (dataOffset < file.size() && file[dataOffset] != '\n') dataOffset++;
+    header.assign(file.begin(), file.begin() + dataOffset);
+    if (dataOffset < file.size()) dataOffset++;
+    if (header.find("\"adpcm\"") != std::string::npos) {
+      fprintf(stderr, "❌ %s sudah ADPCM\n", argv[1]);
+      return 1;
+    }
+  }
+
+  std::vector<uint8_t> pcm(file.begin() + dataOffset, file.end());
+  if (pcm.empty()) {
+    fprintf(stderr, "❌ Data audio kosong\n");
+    return 1;
+  }
+
+  PCMNormalize::normalize(pcm.data(), pcm.size());
+  LoopPoints loop = {0, (uint32_t)pcm.size()};
+  if (!LoopAnalyzer::find(pcm.data(), (uint32_t)pcm.size(), loop)) {
+    loop.start = 0;
+    loop.end = (uint32_t)pcm.size();
+  }
+
+  uint32_t spb = ImaAdpcm::samplesPerBlock(blockBytes);
+  uint32_t blocks = ((uint32_t)pcm.size() + spb - 1) / spb;
+  std::vector<uint8_t> encoded(blocks * blockBytes);
+  ImaAdpcmState state = {0, 0};
+  for (uint32_t b = 0; b < blocks; b++) {
+    uint32_t pos = b * spb;
+    uint32_t count = (uint32_t)pcm.size() - pos;
+    if (count > spb) count = spb;
+    ImaAdpcm::encodeBlock(pcm.data() + pos, count, encoded.data() + b * blockBytes, blockBytes, state);
+  }
+
+  char fields[160];
+  snprintf(fields, sizeof(fields),
+           "\"format\":\"adpcm\",\"block\":%u,\"normalized\":1,\"loop_start\":%u,\"loop_end\":%u}\n",
+           blockBytes, loop.start, loop.end);
+  std::string outHeader = "{" + filterHeader(header) + fields;
+
+  FILE *out = fopen(argv[2], "wb");
+  if (!out) {
+    fprintf(stderr, "❌ Gagal buat %s\n", argv[2]);
+    return 1;
+  }
+  fwrite(outHeader.data(), 1, outHeader.size(), out);
+  fwrite(encoded.data(), 1, encoded.size(), out);
+  fclose(out);
+
+  printf("✅ %s: %zu -> %zu bytes (%.2fx), loop %u-%u\n", argv[2],
+         file.size(), outHeader.size() + encoded.size(),
+         (double)file.size() / (outHeader.size() + encoded.size()), loop.start, loop.end);
+  return 0;
+}
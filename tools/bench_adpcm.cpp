@@ -0,0 +1,125 @@
+// Benchmark host untuk decoder IMA-ADPCM vs jalur PCM 8-bit.
+// Mengukur biaya per sample jalur streaming render (ring -> FIFO PCM):
+// PCM8 = salin byte, ADPCM = decodeBlock + salin. Juga cek kualitas
+// round-trip (SNR, error maksimum) dan rasio ukuran.
+//
+// Build & run dari root project:
+//   g++ -O2 -std=c++17 -Iinclude tools/bench_adpcm.cpp src/ImaAdpcm.cpp -o /tmp/bench_adpcm
+//   /tmp/bench_adpcm
+//
+// Exit code != 0 kalau SNR di bawah batas.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "ImaAdpcm.h"
+
+#define FIFO_SIZE 4096
+#define MIN_SNR_DB 20.0
+
+static uint8_t fifo[FIFO_SIZE];
+static volatile uint32_t sink;  // supaya loop tidak di-optimize habis
+
+// Sinyal mirip rekaman engine: pulsa + harmonik + noise
+static void fillEngineLike(std::vector<uint8_t> &buf, uint32_t seed) {
+  uint32_t x = seed;
+  for (size_t i = 0; i < buf.size(); i++) {
+    x = x * 1664525u + 1013904223u;
+    double t = (double)i / 97.3;
+    double v = 50.0 * sin(2 * M_PI * t) + 25.0 * sin(2 * M_PI * 2.5 * t + 1.0);
+    int noise = (int)((x >> 24) & 0x0F) - 8;
+    int s = 128 + (int)v + noise;
+    buf[i] = (uint8_t)(s < 0 ? 0 : (s > 255 ? 255 : s));
+  }
+}
+
+static std::vector<uint8_t> encode(const std::vector<uint8_t> &pcm, uint32_t blockBytes) {
+  uint32_t spb = ImaAdpcm::samplesPerBlock(blockBytes);
+  uint32_t blocks = ((uint32_t)pcm.size() + spb - 1) / spb;
+  std::vector<uint8_t> out(blocks * blockBytes);
+  ImaAdpcmState state = {0, 0};
+  for (uint32_t b = 0; b < blocks; b++) {
+    uint32_t pos = b * spb;
+    uint32_t count = (uint32_t)pcm.size() - pos;
+    if (count > spb) count = spb;
+    ImaAdpcm::encodeBlock(pcm.data() + pos, count, out.data() + b * blockBytes, blockBytes, state);
+  }
+  return out;
+}
+
+// Jalur PCM8: salin ring ke FIFO per blok (sama dengan tanpa decode)
+static double timePCM(const std::vector<uint8_t> &pcm, uint32_t blockBytes) {
+  auto t0 = std::chrono::steady_clock::now();
+  uint32_t head = 0;
+  for (size_t pos = 0; pos + blockBytes <= pcm.size(); pos += blockBytes) {
+    for (uint32_t i = 0; i < blockBytes; i++) fifo[(head + i) & (FIFO_SIZE - 1)] = pcm[pos + i];
+    head += blockBytes;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  sink = fifo[head & (FIFO_SIZE - 1)];
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)head;
+}
+
+// Jalur ADPCM: decode blok lalu salin ke FIFO (AudioStreamer::decodeAhead)
+static double timeADPCM(const std::vector<uint8_t> &enc, uint32_t blockBytes) {
+  uint32_t spb = ImaAdpcm::samplesPerBlock(blockBytes);
+  std::vector<uint8_t> tmp(spb);
+  auto t0 = std::chrono::steady_clock::now();
+  uint32_t head = 0;
+  for (size_t pos = 0; pos + blockBytes <= enc.size(); pos += blockBytes) {
+    ImaAdpcm::decodeBlock(enc.data() + pos, blockBytes, tmp.data());
+    for (uint32_t i = 0; i < spb; i++) fifo[(head + i) & (FIFO_SIZE - 1)] = tmp[i];
+    head += spb;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  sink = fifo[head & (FIFO_SIZE - 1)];
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)head;
+}
+
+int main() {
+  const uint32_t blockSizes[] = {64, 256, 1024};
+  std::vector<uint8_t> pcm(512 * 1024);
+  fillEngineLike(pcm, 1234);
+  bool ok = true;
+
+  printf("%-6s %10s %8s %8s %8s %12s %12s %8s\n",
+         "block", "bytes", "ratio", "snr dB", "maxerr", "pcm ns/smp", "adpcm ns/smp", "cost");
+  for (uint32_t blockBytes : blockSizes) {
+    std::vector<uint8_t> enc = encode(pcm, blockBytes);
+
+    // Round-trip
+    uint32_t spb = ImaAdpcm::samplesPerBlock(blockBytes);
+    std::vector<uint8_t> dec(enc.size() / blockBytes * spb);
+    for (size_t b = 0; b < enc.size() / blockBytes; b++) {
+      ImaAdpcm::decodeBlock(enc.data() + b * blockBytes, blockBytes, dec.data() + b * spb);
+    }
+    double sig = 0, err = 0;
+    int maxErr = 0;
+    for (size_t i = 0; i < pcm.size(); i++) {
+      int s = (int)pcm[i] - 128;
+      int e = (int)dec[i] - (int)pcm[i];
+      sig += (double)s * s;
+      err += (double)e * e;
+      if (abs(e) > maxErr) maxErr = abs(e);
+    }
+    double snr = err > 0 ? 10.0 * log10(sig / err) : 99.0;
+    if (snr < MIN_SNR_DB) ok = false;
+
+    double best[2] = {1e30, 1e30};
+    for (int it = 0; it < 10; it++) {
+      double p = timePCM(pcm, blockBytes);
+      double a = timeADPCM(enc, blockBytes);
+      if (p < best[0]) best[0] = p;
+      if (a < best[1]) best[1] = a;
+    }
+
+    printf("%-6u %10zu %7.2fx %8.1f %8d %12.2f %12.2f %7.1fx\n",
+           blockBytes, enc.size(), (double)pcm.size() / enc.size(), snr, maxErr,
+           best[0], best[1], best[1] / best[0]);
+  }
+
+  printf(ok ? "✅ Kualitas round-trip OK\n" : "❌ SNR di bawah batas\n");
+  return ok ? 0 : 1;
+}
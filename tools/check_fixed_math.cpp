@@ -0,0 +1,145 @@
+// Cek host untuk FixedMath (Q16 + tabel easing constexpr).
+// Membandingkan easeQ16 di semua input Q16 dengan kurva referensi float
+// (libm), node tabel constexpr dengan libm, helper q16Mul/q16Ratio/q16Lerp
+// dengan double, dan ramp envelope Q16 dengan versi float lama.
+// Juga mengukur biaya per panggilan float (sinf) vs tabel.
+//
+// Build & run dari root project:
+//   g++ -O2 -std=c++11 -Iinclude tools/check_fixed_math.cpp src/FixedMath.cpp -o /tmp/check_fixed_math
+//   /tmp/check_fixed_math
+//
+// Exit code != 0 kalau ada error di atas batas.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "FixedMath.h"
+
+static const char *const CURVE_NAMES[EASE_COUNT] = {"linear", "sine", "smooth", "exp"};
+
+// Batas error interpolasi tabel (LSB Q16): rounding + h^2/8 * max f''
+// (h = 1/64); eksponensial paling melengkung di ujung.
+static const double CURVE_BOUND[EASE_COUNT] = {1.0, 8.0, 16.0, 128.0};
+
+static double easeFloat(uint8_t curve, double t) {
+  switch (curve) {
+    case EASE_SINE:   return sin(t * M_PI * 0.5);
+    case EASE_SMOOTH: return t * t * (3.0 - 2.0 * t);
+    case EASE_EXP:    return (exp2(10.0 * t) - 1.0) / 1023.0;
+    default:          return t;
+  }
+}
+
+static bool checkCurves() {
+  bool ok = true;
+  printf("%-8s %14s %14s %10s\n", "kurva", "node max (LSB)", "lut max (LSB)", "batas");
+  for (uint8_t c = 0; c < EASE_COUNT; c++) {
+    double nodeErr = 0.0;
+    for (uint32_t i = 0; i < EASE_LUT_SIZE; i++) {
+      double ref = easeFloat(c, (double)i / (EASE_LUT_SIZE - 1)) * Q16_ONE;
+      nodeErr = fmax(nodeErr, fabs(EASE_TABLES[c].v[i] - ref));
+    }
+
+    double lutErr = 0.0;
+    q16_t prev = 0;
+    bool monotonic = true;
+    for (q16_t t = 0; t <= Q16_ONE; t++) {
+      q16_t v = easeQ16(c, t);
+      if (v < prev) monotonic = false;
+      prev = v;
+      lutErr = fmax(lutErr, fabs(v - easeFloat(c, (double)t / Q16_ONE) * Q16_ONE));
+    }
+
+    bool pass = nodeErr <= 1.0 && lutErr <= CURVE_BOUND[c] && monotonic;
+    printf("%-8s %14.2f %14.2f %10.0f %s\n", CURVE_NAMES[c], nodeErr, lutErr, CURVE_BOUND[c],
+           pass ? "✅" : (monotonic ? "❌" : "❌ tidak monoton"));
+    ok = ok && pass;
+  }
+  return ok;
+}
+
+static bool checkHelpers() {
+  uint32_t x = 12345;
+  double mulErr = 0.0, ratioErr = 0.0, lerpErr = 0.0;
+  for (int i = 0; i < 1000000; i++) {
+    x = x * 1664525u + 1013904223u;
+    q16_t a = (q16_t)(x >> 8) - (1 << 23);       // +-128.0
+    x = x * 1664525u + 1013904223u;
+    q16_t b = (q16_t)(x >> 15);                  // 0..2.0
+    mulErr = fmax(mulErr, fabs(q16Mul(a, b) - (double)a * b / Q16_ONE));
+
+    uint32_t den = (x >> 12) + 1;
+    uint32_t num = x % (den + 1);
+    ratioErr = fmax(ratioErr, fabs(q16Ratio(num, den) - (double)num * Q16_ONE / den));
+
+    int32_t from = (int32_t)(x % 3001) - 1000, to = (int32_t)((x >> 11) % 3001) - 1000;
+    q16_t t = (q16_t)(x % (Q16_ONE + 1));
+    lerpErr = fmax(lerpErr, fabs(q16Lerp(from, to, t) - (from + (double)(to - from) * t / Q16_ONE)));
+  }
+  bool ok = mulErr <= 0.5 && ratioErr <= 1.0 && lerpErr <= 0.5;
+  printf("q16Mul max %.3f LSB, q16Ratio max %.3f LSB, q16Lerp max %.3f permil %s\n",
+         mulErr, ratioErr, lerpErr, ok ? "✅" : "❌");
+  return ok;
+}
+
+// Ramp envelope: level permil -1000..2000, segmen 5..1000ms per tick 5ms.
+// Versi lama: float progress dibulatkan ke 1/1000 lalu dibagi integer.
+static bool checkEnvelopeRamp() {
+  bool ok = true;
+  for (uint8_t c = 0; c < EASE_COUNT; c++) {
+    double oldErr = 0.0, newErr = 0.0;
+    for (int32_t from = -1000; from <= 2000; from += 125) {
+      for (int32_t to = -1000; to <= 2000; to += 125) {
+        for (uint32_t ms = 5; ms <= 1000; ms += 35) {
+          for (uint32_t t = 0; t <= ms; t += 5) {
+            double exact = from + (to - from) * easeFloat(c, (double)t / ms);
+            int32_t oldP = (int32_t)(easeFloat(c, (float)t / ms) * 1000.0f + 0.5f);
+            int32_t oldLevel = from + (to - from) * oldP / 1000;
+            int32_t newLevel = q16Lerp(from, to, easeQ16(c, q16Ratio(t, ms)));
+            oldErr = fmax(oldErr, fabs(oldLevel - exact));
+            newErr = fmax(newErr, fabs(newLevel - exact));
+          }
+        }
+      }
+    }
+    // Rentang level 3000 permil x error kurva + pembulatan
+    double bound = 3000.0 * CURVE_BOUND[c] / Q16_ONE + 1.0;
+    bool pass = newErr <= bound;
+    printf("envelope %-8s float lama max %.2f, q16 max %.2f permil (batas %.2f) %s\n",
+           CURVE_NAMES[c], oldErr, newErr, bound, pass ? "✅" : "❌");
+    ok = ok && pass;
+  }
+  return ok;
+}
+
+static void bench() {
+  const int N = 10000000;
+  volatile int32_t sink = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    uint32_t t = i % 400, ms = 400;
+    float p = sinf((float)t / ms * (float)M_PI * 0.5f);
+    sink = sink + (int32_t)(p * 1000.0f + 0.5f);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    uint32_t t = i % 400, ms = 400;
+    sink = sink + easeQ16(EASE_SINE, q16Ratio(t, ms));
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double fNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+  double qNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / N;
+  printf("sine ramp: float %.2f ns, q16 tabel %.2f ns per panggilan (host)\n", fNs, qNs);
+}
+
+int main() {
+  bool ok = checkCurves();
+  ok = checkHelpers() && ok;
+  ok = checkEnvelopeRamp() && ok;
+  bench();
+  printf(ok ? "✅ FixedMath dalam batas\n" : "❌ FixedMath di luar batas\n");
+  return ok ? 0 : 1;
+}
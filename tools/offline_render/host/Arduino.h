@@ -0,0 +1,276 @@
+#pragma once
+// Shim Arduino-ESP32 + FreeRTOS minimal untuk build host offline_render.
+// Hanya API yang dipakai firmware; implementasi di HostRuntime.cpp.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+#include <string>
+#include "HostRuntime.h"
+
+// ArduinoJson di host: aktifkan adapter String, tanpa Stream/PROGMEM
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 0
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 0
+#define ARDUINOJSON_ENABLE_PROGMEM 0
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define ARDUINO_ISR_ATTR
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+
+// ===== String =====
+class String {
+public:
+  String() {}
+  String(const char *s) : str(s ? s : "") {}
+  String(const std::string &s) : str(s) {}
+  String(char c) : str(1, c) {}
+  String(int v) : str(std::to_string(v)) {}
+  String(unsigned int v) : str(std::to_string(v)) {}
+  String(long v) : str(std::to_string(v)) {}
+  String(unsigned long v) : str(std::to_string(v)) {}
+  String(float v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+  String(double v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+
+  const char *c_str() const { return str.c_str(); }
+  unsigned int length() const { return (unsigned int)str.size(); }
+  bool isEmpty() const { return str.empty(); }
+  void reserve(unsigned int n) { str.reserve(n); }
+
+  bool concat(const String &s) { str += s.str; return true; }
+  bool concat(const char *s) { if (s) str += s; return true; }
+  bool concat(const char *s, unsigned int n) { if (s) str.append(s, n); return true; }
+  bool concat(char c) { str += c; return true; }
+  bool concat(int v) { str += std::to_string(v); return true; }
+  bool concat(unsigned int v) { str += std::to_string(v); return true; }
+  bool concat(long v) { str += std::to_string(v); return true; }
+  bool concat(unsigned long v) { str += std::to_string(v); return true; }
+  bool concat(double v) { String t(v); str += t.str; return true; }
+
+  template <class T> String &operator+=(const T &v) { concat(v); return *this; }
+
+  char operator[](unsigned int i) const { return i < str.size() ? str[i] : 0; }
+  char &operator[](unsigned int i) { return str[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  bool operator==(const String &o) const { return str == o.str; }
+  bool operator==(const char *o) const { return str == (o ? o : ""); }
+  bool operator!=(const String &o) const { return str != o.str; }
+  bool operator!=(const char *o) const { return !(*this == o); }
+  bool operator<(const String &o) const { return str < o.str; }
+  bool equals(const String &o) const { return str == o.str; }
+
+  bool startsWith(const String &p) const { return str.compare(0, p.str.size(), p.str) == 0; }
+  bool endsWith(const String &s) const {
+    return str.size() >= s.str.size() && str.compare(str.size() - s.str.size(), s.str.size(), s.str) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const { return find(str.find(c, from)); }
+  int indexOf(const String &s, unsigned int from = 0) const { return find(str.find(s.str, from)); }
+  int lastIndexOf(char c) const { return find(str.rfind(c)); }
+  int lastIndexOf(const String &s) const { return find(str.rfind(s.str)); }
+  String substring(unsigned int from) const { return from < str.size() ? String(str.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= str.size()) return String();
+    return String(str.substr(from, to - from));
+  }
+  void replace(const String &a, const String &b) {
+    if (a.str.empty()) return;
+    size_t pos = 0;
+    while ((pos = str.find(a.str, pos)) != std::string::npos) {
+      str.replace(pos, a.str.size(), b.str);
+      pos += b.str.size();
+    }
+  }
+  void remove(unsigned int index) { if (index < str.size()) str.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < str.size()) str.erase(index, count); }
+  void trim() {
+    size_t a = str.find_first_not_of(" \t\r\n");
+    size_t b = str.find_last_not_of(" \t\r\n");
+    str = (a == std::string::npos) ? std::string() : str.substr(a, b - a + 1);
+  }
+  void toLowerCase() { for (auto &c : str) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (auto &c : str) c = (char)toupper((unsigned char)c); }
+  long toInt() const { return atol(str.c_str()); }
+  float toFloat() const { return (float)atof(str.c_str()); }
+
+  // Dipakai adapter ArduinoJson
+  size_t write(uint8_t c) { str += (char)c; return 1; }
+
+private:
+  std::string str;
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+  void fromDouble(double v, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    str = buf;
+  }
+};
+
+inline String operator+(const String &a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, const char *b) { String r(a); r.concat(b); return r; }
+inline String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, char b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, int b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, unsigned int b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, long b) { String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, unsigned long b) { String r(a); r.concat(b); return r; }
+
+// ===== Print (Serial, File) =====
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t *buf, size_t size) = 0;
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned int v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t print(double v, int d = 2) { return print(String(v, d)); }
+  size_t println() { return print("\n"); }
+  template <class T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    return write((const uint8_t *)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+  }
+};
+
+// Serial -> stderr, diberi prefix waktu virtual per baris
+class HostSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+extern HostSerial Serial;
+
+// ===== Waktu =====
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// ===== GPIO / ADC / DAC =====
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+uint16_t analogRead(uint8_t pin);
+int8_t digitalPinToAnalogChannel(uint8_t pin);
+void dacWrite(uint8_t pin, uint8_t value);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ===== Memori =====
+bool psramFound();
+void *ps_malloc(size_t size);
+
+class EspClass {
+public:
+  void restart();
+  uint32_t getFreeHeap() { return 200 * 1024; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getCpuFreqMHz() { return 1000; }   // "cycle" host = nanodetik wall clock
+  uint32_t getCycleCount();
+};
+extern EspClass ESP;
+
+// ===== Timer hardware =====
+struct hw_timer_t;
+hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerEnd(hw_timer_t *timer);
+void timerAttachInterrupt(hw_timer_t *timer, void (*fn)(void), bool edge);
+void timerAlarmWrite(hw_timer_t *timer, uint64_t alarmValue, bool autoreload);
+void timerAlarmEnable(hw_timer_t *timer);
+void timerAlarmDisable(hw_timer_t *timer);
+
+// ===== FreeRTOS =====
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+struct HostTask;
+struct HostQueue;
+struct HostSemaphore;
+typedef HostTask *TaskHandle_t;
+typedef HostQueue *QueueHandle_t;
+typedef HostSemaphore *SemaphoreHandle_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Satu thread host, task kooperatif: critical section tidak perlu lock
+struct portMUX_TYPE { int unused; };
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR() ((void)0)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                       void *param, UBaseType_t priority, TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xPortGetCoreID();
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
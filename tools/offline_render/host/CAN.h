@@ -0,0 +1,4 @@
+#pragma once
+// OBD2Control tidak ikut di-link di host; header ini hanya supaya
+// include di SystemManager tetap bisa dikompilasi.
+#include <Arduino.h>
@@ -0,0 +1,61 @@
+#pragma once
+// Shim FS/File di atas filesystem host (stdio + dirent). Root LittleFS
+// dipetakan ke folder host lewat hostSetFsRoot().
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#define SeekSet 0
+#define SeekCur 1
+#define SeekEnd 2
+
+struct HostFileImpl;
+
+class File : public Print {
+public:
+  File() {}
+  explicit File(std::shared_ptr<HostFileImpl> impl) : impl(impl) {}
+
+  explicit operator bool() const;
+  size_t size();
+  size_t position();
+  bool seek(uint32_t pos, int mode = SeekSet);
+  size_t read(uint8_t *buf, size_t n);
+  int read();
+  int peek();
+  int available();
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+  String readStringUntil(char terminator);
+  void flush();
+  void close();
+  const char *name();   // basename, seperti arduino-esp32 2.x
+  const char *path();
+  bool isDirectory();
+  File openNextFile();
+
+private:
+  std::shared_ptr<HostFileImpl> impl;
+};
+
+namespace fs {
+class FS {
+public:
+  bool begin(bool formatOnFail = false);
+  bool format();
+  File open(const char *path, const char *mode = "r");
+  File open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to);
+  bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char *path);
+  bool mkdir(const String &path) { return mkdir(path.c_str()); }
+  bool rmdir(const char *path);
+  bool rmdir(const String &path) { return rmdir(path.c_str()); }
+  size_t totalBytes() { return 1536 * 1024; }
+  size_t usedBytes();
+};
+}  // namespace fs
@@ -0,0 +1,41 @@
+// Registry characteristic NimBLE: runner menulis/membaca lewat UUID
+#include <NimBLEDevice.h>
+#include <map>
+#include <memory>
+
+static NimBLEServer server;
+static NimBLEAdvertising advertising;
+static std::map<std::string, std::unique_ptr<NimBLECharacteristic>> characteristics;
+
+NimBLEServer *NimBLEDevice::createServer() { return &server; }
+NimBLEAdvertising *NimBLEDevice::getAdvertising() { return &advertising; }
+
+NimBLECharacteristic *NimBLEService::createCharacteristic(const char *uuid, uint32_t properties) {
+  auto &slot = characteristics[uuid];
+  slot.reset(new NimBLECharacteristic(uuid, properties));
+  return slot.get();
+}
+
+// Tidak ada central; notify hanya dicatat di log
+void NimBLECharacteristic::notify() {
+  Serial.printf("host: BLE notify %s (%u byte)\n", uuid.c_str(), (unsigned)value.size());
+}
+
+// Sama dengan NimBLE: nilai diset dulu, lalu onWrite dipanggil di konteks
+// pemanggil (di ESP32 itu task host NimBLE)
+bool hostBleWrite(const char *uuid, const uint8_t *data, size_t len) {
+  auto it = characteristics.find(uuid);
+  if (it == characteristics.end()) return false;
+  NimBLECharacteristic *c = it->second.get();
+  c->setValue(data, len);
+  if (c->getCallbacks()) c->getCallbacks()->onWrite(c);
+  return true;
+}
+
+std::string hostBleRead(const char *uuid) {
+  auto it = characteristics.find(uuid);
+  if (it == characteristics.end()) return std::string();
+  NimBLECharacteristic *c = it->second.get();
+  if (c->getCallbacks()) c->getCallbacks()->onRead(c);
+  return c->getValue();
+}
@@ -0,0 +1,176 @@
+// LittleFS di host: path firmware "/audio/x.raw" -> <root>/audio/x.raw
+#include <LittleFS.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+fs::FS LittleFS;
+
+static std::string fsRoot = ".";
+
+void hostSetFsRoot(const std::string &dir) { fsRoot = dir; }
+
+static std::string hostPath(const char *path) {
+  std::string p = path ? path : "/";
+  if (p.empty() || p[0] != '/') p = "/" + p;
+  return fsRoot + p;
+}
+
+struct HostFileImpl {
+  std::string path;   // path firmware
+  std::string base;
+  FILE *fp = nullptr;
+  bool dir = false;
+  std::vector<std::string> entries;  // isi folder, terurut (deterministik)
+  size_t nextEntry = 0;
+
+  ~HostFileImpl() {
+    if (fp) fclose(fp);
+  }
+};
+
+File::operator bool() const { return impl && (impl->fp || impl->dir); }
+
+size_t File::size() {
+  if (!impl || !impl->fp) return 0;
+  long pos = ftell(impl->fp);
+  fseek(impl->fp, 0, SEEK_END);
+  long end = ftell(impl->fp);
+  fseek(impl->fp, pos, SEEK_SET);
+  return (size_t)end;
+}
+
+size_t File::position() { return (impl && impl->fp) ? (size_t)ftell(impl->fp) : 0; }
+
+bool File::seek(uint32_t pos, int mode) {
+  if (!impl || !impl->fp) return false;
+  int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+  return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::read(uint8_t *buf, size_t n) {
+  if (!impl || !impl->fp) return 0;
+  return fread(buf, 1, n, impl->fp);
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  if (!impl || !impl->fp) return -1;
+  int c = fgetc(impl->fp);
+  if (c != EOF) ungetc(c, impl->fp);
+  return c == EOF ? -1 : c;
+}
+
+int File::available() {
+  if (!impl || !impl->fp) return 0;
+  return (int)(size() - position());
+}
+
+size_t File::write(const uint8_t *buf, size_t n) {
+  if (!impl || !impl->fp) return 0;
+  return fwrite(buf, 1, n, impl->fp);
+}
+
+String File::readStringUntil(char terminator) {
+  String s;
+  int c;
+  while ((c = read()) >= 0 && c != terminator) s += (char)c;
+  return s;
+}
+
+void File::flush() {
+  if (impl && impl->fp) fflush(impl->fp);
+}
+
+void File::close() { impl.reset(); }
+
+const char *File::name() { return impl ? impl->base.c_str() : ""; }
+const char *File::path() { return impl ? impl->path.c_str() : ""; }
+bool File::isDirectory() { return impl && impl->dir; }
+
+File File::openNextFile() {
+  if (!impl || !impl->dir || impl->nextEntry >= impl->entries.size()) return File();
+  std::string child = impl->path;
+  if (child.empty() || child.back() != '/') child += "/";
+  child += impl->entries[impl->nextEntry++];
+  return LittleFS.open(child.c_str(), "r");
+}
+
+namespace fs {
+
+bool FS::begin(bool formatOnFail) {
+  struct stat st;
+  return stat(fsRoot.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool FS::format() { return false; }  // root host tidak pernah dihapus
+
+File FS::open(const char *path, const char *mode) {
+  std::string hp = hostPath(path);
+  auto impl = std::make_shared<HostFileImpl>();
+  impl->path = path ? path : "/";
+  size_t slash = impl->path.find_last_of('/');
+  impl->base = slash == std::string::npos ? impl->path : impl->path.substr(slash + 1);
+
+  struct stat st;
+  bool isDir = stat(hp.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  if (isDir) {
+    if (mode[0] != 'r') return File();
+    impl->dir = true;
+    if (DIR *d = opendir(hp.c_str())) {
+      while (dirent *e = readdir(d)) {
+        if (e->d_name[0] == '.') continue;
+        impl->entries.push_back(e->d_name);
+      }
+      closedir(d);
+    }
+    std::sort(impl->entries.begin(), impl->entries.end());
+    return File(impl);
+  }
+
+  const char *fmode = mode[0] == 'w' ? "w+b" : (mode[0] == 'a' ? "a+b" : "rb");
+  impl->fp = fopen(hp.c_str(), fmode);
+  if (!impl->fp) return File();
+  return File(impl);
+}
+
+bool FS::exists(const char *path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) { return unlink(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char *from, const char *to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path) {
+  return ::mkdir(hostPath(path).c_str(), 0755) == 0 || exists(path);
+}
+
+bool FS::rmdir(const char *path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+
+static size_t dirBytes(const std::string &dir) {
+  size_t total = 0;
+  if (DIR *d = opendir(dir.c_str())) {
+    while (dirent *e = readdir(d)) {
+      if (e->d_name[0] == '.') continue;
+      std::string p = dir + "/" + e->d_name;
+      struct stat st;
+      if (stat(p.c_str(), &st) != 0) continue;
+      total += S_ISDIR(st.st_mode) ? dirBytes(p) : (size_t)st.st_size;
+    }
+    closedir(d);
+  }
+  return total;
+}
+
+size_t FS::usedBytes() { return dirBytes(fsRoot); }
+
+}  // namespace fs
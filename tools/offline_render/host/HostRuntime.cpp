@@ -0,0 +1,572 @@
+// Runtime host offline_render: jam virtual, FreeRTOS kooperatif di atas
+// ucontext, timer alarm, GPIO/ADC/DAC virtual (termasuk ADC DMA), Serial.
+//
+// Semua task jalan di satu thread. Task pindah hanya di titik blocking
+// (vTaskDelay, queue, semaphore, notify), jadi urutan eksekusi sepenuhnya
+// ditentukan prioritas + waktu virtual: render yang sama -> output sama.
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_adc_cal.h>
+#include <ucontext.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+HostSerial Serial;
+EspClass ESP;
+
+// ===== Jam virtual =====
+static uint64_t nowUs = 0;
+
+uint64_t hostNowUs() { return nowUs; }
+void hostSetNowUs(uint64_t us) { nowUs = us; }
+int64_t esp_timer_get_time() { return (int64_t)nowUs; }
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+unsigned long micros() { return (unsigned long)nowUs; }
+
+// ===== Task =====
+#define HOST_TASK_STACK (256 * 1024)    // kode host butuh stack jauh lebih besar dari ESP32
+#define HOST_MAX_SWITCHES 1000000       // pengaman livelock per pass scheduler
+
+struct HostTask {
+  const char *name;
+  TaskFunction_t fn;
+  void *param;
+  UBaseType_t priority;
+  BaseType_t core;
+  ucontext_t ctx;
+  std::vector<char> stack;
+  uint64_t wakeUs = 0;         // eligible saat nowUs >= wakeUs
+  bool blocked = false;        // menunggu kondisi: eligible juga saat ada event baru
+  uint32_t seenEvent = 0;
+  uint32_t notifyCount = 0;
+  bool finished = false;
+  uint64_t cpuNs = 0;          // wall clock yang dipakai task ini (getCycleCount)
+};
+
+static std::vector<HostTask *> tasks;   // urutan pembuatan (tie-break prioritas)
+static HostTask *current = nullptr;     // nullptr = konteks main (setup/runner/ISR)
+static ucontext_t mainCtx;
+static uint32_t eventCount = 0;
+
+void hostSignal() { eventCount++; }
+
+// ===== Jam CPU per konteks (basis getCycleCount) =====
+// Tiap konteks (task, ISR, main) punya jam kerja sendiri: wall clock yang
+// benar-benar dipakai konteks itu. Analog CCOUNT per core.
+static uint64_t mainCpuNs = 0, isrCpuNs = 0;
+static uint64_t *cpuClock = &mainCpuNs;
+static uint64_t resumedNs = 0;
+
+static uint64_t wallNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void chargeCpu() {
+  uint64_t now = wallNs();
+  if (resumedNs) *cpuClock += now - resumedNs;
+  resumedNs = now;
+}
+
+static void switchCpu(uint64_t *clock) {
+  chargeCpu();
+  cpuClock = clock;
+}
+
+static bool eligible(const HostTask *t) {
+  if (t->finished) return false;
+  if (nowUs >= t->wakeUs) return true;
+  return t->blocked && t->seenEvent != eventCount;
+}
+
+static void trampoline() {
+  HostTask *t = current;
+  t->fn(t->param);
+  vTaskDelete(nullptr);
+}
+
+// Kembali ke scheduler (dipanggil dari task)
+static void yieldTask() {
+  HostTask *t = current;
+  swapcontext(&t->ctx, &mainCtx);
+}
+
+static void reapFinished() {
+  for (size_t i = 0; i < tasks.size();) {
+    if (tasks[i]->finished && tasks[i] != current) {
+      delete tasks[i];
+      tasks.erase(tasks.begin() + i);
+    } else {
+      i++;
+    }
+  }
+}
+
+static HostTask *pickTask() {
+  HostTask *best = nullptr;
+  for (HostTask *t : tasks) {
+    if (eligible(t) && (!best || t->priority > best->priority)) best = t;
+  }
+  return best;
+}
+
+bool hostTasksPending() { return pickTask() != nullptr; }
+
+uint64_t hostNextWakeUs() {
+  uint64_t next = UINT64_MAX;
+  for (HostTask *t : tasks) {
+    if (!t->finished && t->wakeUs < next) next = t->wakeUs;
+  }
+  return next;
+}
+
+void hostRunTasks() {
+  if (current) return;  // hanya dari konteks main
+  uint32_t switches = 0;
+  while (HostTask *t = pickTask()) {
+    if (++switches > HOST_MAX_SWITCHES) {
+      fprintf(stderr, "host: livelock di task %s (t=%llu us)\n", t->name, (unsigned long long)nowUs);
+      exit(3);
+    }
+    t->blocked = false;
+    current = t;
+    switchCpu(&t->cpuNs);
+    swapcontext(&mainCtx, &t->ctx);
+    switchCpu(&mainCpuNs);
+    current = nullptr;
+    reapFinished();
+  }
+}
+
+// Maju waktu dari konteks main sampai target, sambil menjalankan task
+// yang bangun di tengah jalan (dipakai delay() di setup)
+static void advanceMainTo(uint64_t target) {
+  hostRunTasks();
+  for (;;) {
+    uint64_t next = hostNextWakeUs();
+    if (next > target) break;
+    if (next > nowUs) nowUs = next;
+    hostRunTasks();
+  }
+  if (target > nowUs) nowUs = target;
+}
+
+// Tunggu kondisi dengan timeout (ticks = ms). Di task: yield sampai ada
+// event atau deadline. Di main: majukan waktu virtual.
+template <class Cond>
+static bool waitFor(Cond cond, TickType_t ticks) {
+  if (cond()) return true;
+  if (ticks == 0) return false;
+  uint64_t deadline = (ticks == portMAX_DELAY) ? UINT64_MAX : nowUs + (uint64_t)ticks * 1000;
+
+  if (!current) {
+    for (;;) {
+      hostRunTasks();
+      if (cond()) return true;
+      uint64_t next = hostNextWakeUs();
+      if (next == UINT64_MAX || nowUs >= deadline) return cond();
+      nowUs = next < deadline ? (next > nowUs ? next : nowUs + 1) : deadline;
+    }
+  }
+
+  for (;;) {
+    HostTask *t = current;
+    t->wakeUs = deadline;
+    t->blocked = true;
+    t->seenEvent = eventCount;
+    yieldTask();
+    if (cond()) return true;
+    if (nowUs >= deadline) return false;
+  }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  HostTask *t = new HostTask();
+  t->name = name;
+  t->fn = fn;
+  t->param = param;
+  t->priority = priority;
+  t->core = core;
+  t->stack.resize(HOST_TASK_STACK);
+  t->wakeUs = nowUs;
+  getcontext(&t->ctx);
+  t->ctx.uc_stack.ss_sp = t->stack.data();
+  t->ctx.uc_stack.ss_size = t->stack.size();
+  t->ctx.uc_link = nullptr;
+  makecontext(&t->ctx, trampoline, 0);
+  tasks.push_back(t);
+  if (handle) *handle = t;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth,
+                       void *param, UBaseType_t priority, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, 0);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  HostTask *t = task ? task : current;
+  if (!t) return;
+  t->finished = true;
+  hostSignal();
+  if (t == current) {
+    yieldTask();  // tidak pernah kembali
+  }
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (!current) {
+    advanceMainTo(nowUs + (uint64_t)ticks * 1000);
+    return;
+  }
+  // vTaskDelay(0) = yield: minimal 1 us supaya task lain sempat jalan
+  current->wakeUs = nowUs + (ticks ? (uint64_t)ticks * 1000 : 1);
+  current->blocked = false;
+  yieldTask();
+}
+
+void delay(unsigned long ms) { vTaskDelay(ms); }
+void delayMicroseconds(unsigned int us) {}
+void yield() {}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return current; }
+BaseType_t xPortGetCoreID() { return current ? current->core : 1; }
+
+// ===== Notify =====
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  HostTask *t = current;
+  if (!t) return 0;
+  waitFor([t] { return t->notifyCount > 0; }, ticks);
+  uint32_t count = t->notifyCount;
+  if (count) t->notifyCount = clearOnExit ? 0 : count - 1;
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (task) {
+    task->notifyCount++;
+    hostSignal();
+  }
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  xTaskNotifyGive(task);
+  if (woken) *woken = pdTRUE;
+}
+
+// ===== Queue =====
+struct HostQueue {
+  size_t length;
+  size_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  HostQueue *q = new HostQueue();
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+static BaseType_t queueSend(QueueHandle_t q, const void *item, TickType_t ticks, bool front) {
+  if (!waitFor([q] { return q->items.size() < q->length; }, ticks)) return pdFALSE;
+  const uint8_t *p = (const uint8_t *)item;
+  std::vector<uint8_t> v(p, p + q->itemSize);
+  if (front) q->items.push_front(std::move(v));
+  else q->items.push_back(std::move(v));
+  hostSignal();
+  return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) { return queueSend(q, item, ticks, false); }
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t ticks) { return queueSend(q, item, ticks, false); }
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void *item, TickType_t ticks) { return queueSend(q, item, ticks, true); }
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+  if (!waitFor([q] { return !q->items.empty(); }, ticks)) return pdFALSE;
+  memcpy(item, q->items.front().data(), q->itemSize);
+  q->items.pop_front();
+  hostSignal();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { return (UBaseType_t)q->items.size(); }
+
+// ===== Semaphore / mutex =====
+// Task bisa yield sambil memegang mutex (mis. delay di dalam lock), jadi
+// owner tetap dilacak walau hanya ada satu thread.
+struct HostSemaphore {
+  bool recursive;
+  bool isMutex;
+  int count;
+  HostTask *owner;
+  int depth;
+};
+
+static SemaphoreHandle_t newSemaphore(bool isMutex, bool recursive, int count) {
+  HostSemaphore *s = new HostSemaphore();
+  s->isMutex = isMutex;
+  s->recursive = recursive;
+  s->count = count;
+  s->owner = nullptr;
+  s->depth = 0;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return newSemaphore(true, false, 1); }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return newSemaphore(true, true, 1); }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return newSemaphore(false, false, 0); }
+void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (!waitFor([sem] { return sem->count > 0; }, ticks)) return pdFALSE;
+  sem->count--;
+  if (sem->isMutex) {
+    sem->owner = current;
+    sem->depth = 1;
+  }
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  if (sem->isMutex) {
+    if (sem->count > 0) return pdFALSE;
+    sem->owner = nullptr;
+    sem->depth = 0;
+  } else if (sem->count > 0) {
+    return pdFALSE;
+  }
+  sem->count++;
+  hostSignal();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (sem->count == 0 && sem->owner == current) {
+    sem->depth++;
+    return pdTRUE;
+  }
+  return xSemaphoreTake(sem, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+  if (sem->owner != current || sem->count > 0) return pdFALSE;
+  if (--sem->depth > 0) return pdTRUE;
+  return xSemaphoreGive(sem);
+}
+
+// ===== Timer hardware =====
+// APB 80 MHz / divider = tick timer; alarm dalam tick
+struct hw_timer_t {
+  uint16_t divider;
+  uint64_t alarm;
+  void (*isr)(void);
+  bool enabled;
+};
+
+static hw_timer_t hostTimer;
+
+hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool countUp) {
+  hostTimer = hw_timer_t{divider, 0, nullptr, false};
+  return &hostTimer;
+}
+void timerEnd(hw_timer_t *timer) { timer->enabled = false; }
+void timerAttachInterrupt(hw_timer_t *timer, void (*fn)(void), bool edge) { timer->isr = fn; }
+void timerAlarmWrite(hw_timer_t *timer, uint64_t alarmValue, bool autoreload) { timer->alarm = alarmValue; }
+void timerAlarmEnable(hw_timer_t *timer) { timer->enabled = true; }
+void timerAlarmDisable(hw_timer_t *timer) { timer->enabled = false; }
+
+bool hostTimerActive() { return hostTimer.enabled && hostTimer.isr && hostTimer.alarm; }
+uint64_t hostTimerPeriodUs() { return hostTimer.alarm * hostTimer.divider / 80; }
+void hostTimerFire() {
+  if (!hostTimerActive()) return;
+  uint64_t *prev = cpuClock;
+  chargeCpu();
+  isrCpuNs = 0;  // ISR mulai tepat di tick virtual, kerja ISR lalu tidak menggeser
+  cpuClock = &isrCpuNs;
+  hostTimer.isr();
+  switchCpu(prev);
+}
+
+// ===== GPIO / ADC / DAC =====
+static uint8_t digitalLevel[64];
+static uint16_t analogLevel[64];
+static uint8_t dacLevel[64];
+static bool pinsInit = false;
+
+static void initPins() {
+  if (pinsInit) return;
+  memset(digitalLevel, HIGH, sizeof(digitalLevel));  // tombol pull-up: lepas = HIGH
+  memset(dacLevel, 128, sizeof(dacLevel));
+  pinsInit = true;
+}
+
+void hostSetDigital(uint8_t pin, bool level) { initPins(); digitalLevel[pin & 63] = level ? HIGH : LOW; }
+void hostSetAnalog(uint8_t pin, uint16_t value) { analogLevel[pin & 63] = value; }
+uint8_t hostDacValue(uint8_t pin) { initPins(); return dacLevel[pin & 63]; }
+
+void pinMode(uint8_t pin, uint8_t mode) { initPins(); }
+int digitalRead(uint8_t pin) { initPins(); return digitalLevel[pin & 63]; }
+void digitalWrite(uint8_t pin, uint8_t val) {}
+uint16_t analogRead(uint8_t pin) { return analogLevel[pin & 63]; }
+void dacWrite(uint8_t pin, uint8_t value) { initPins(); dacLevel[pin & 63] = value; }
+
+// ADC1 channel 0-7 (GPIO 36..39, 32..35); ADC2 tidak dimodelkan
+static const uint8_t ADC1_PINS[8] = {36, 37, 38, 39, 32, 33, 34, 35};
+
+int8_t digitalPinToAnalogChannel(uint8_t pin) {
+  for (int8_t ch = 0; ch < 8; ch++) {
+    if (ADC1_PINS[ch] == pin) return ch;
+  }
+  return -1;
+}
+
+// ===== ADC continuous (DMA) =====
+// Frame conv_num_each_intr byte siap tiap (jumlah konversi / sample_freq_hz);
+// adc_digi_read_bytes tidur sampai frame berikutnya lalu mengisinya dari
+// level analog pin. Tertinggal > 4 frame = buffer DMA penuh, frame lama dibuang.
+static bool adcInit = false, adcRunning = false;
+static uint32_t adcFrameBytes = 0, adcRate = 0;
+static uint32_t adcChanMask = 0;
+static uint64_t adcNextUs = 0;
+
+static uint64_t adcFrameUs() {
+  return (uint64_t)(adcFrameBytes / SOC_ADC_DIGI_RESULT_BYTES) * 1000000 / adcRate;
+}
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t *init_config) {
+  if (adcInit || !init_config->conv_num_each_intr) return ESP_ERR_INVALID_STATE;
+  adcFrameBytes = init_config->conv_num_each_intr;
+  adcChanMask = init_config->adc1_chan_mask & 0xFF;
+  adcInit = true;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t *config) {
+  if (!adcInit || config->sample_freq_hz < 20000 || config->sample_freq_hz > 2000000) return ESP_FAIL;
+  adcRate = config->sample_freq_hz;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_start() {
+  if (!adcInit || !adcRate) return ESP_ERR_INVALID_STATE;
+  adcRunning = true;
+  adcNextUs = nowUs + adcFrameUs();
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_stop() {
+  adcRunning = false;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_deinitialize() {
+  adcInit = adcRunning = false;
+  adcRate = 0;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t *buf, uint32_t length_max, uint32_t *out_length,
+                              uint32_t timeout_ms) {
+  *out_length = 0;
+  if (!adcRunning) return ESP_ERR_INVALID_STATE;
+  uint64_t frameUs = adcFrameUs();
+  if (nowUs > adcNextUs + 4 * frameUs) adcNextUs = nowUs - nowUs % frameUs;  // overflow
+
+  if (adcNextUs > nowUs) {
+    if (adcNextUs - nowUs > (uint64_t)timeout_ms * 1000) {
+      vTaskDelay(timeout_ms);
+      return ESP_ERR_TIMEOUT;
+    }
+    if (current) {
+      current->wakeUs = adcNextUs;
+      current->blocked = false;
+      yieldTask();
+    } else {
+      advanceMainTo(adcNextUs);
+    }
+  }
+  adcNextUs += frameUs;
+
+  // Pattern bergiliran di semua channel di mask
+  uint32_t n = std::min(adcFrameBytes, length_max) / SOC_ADC_DIGI_RESULT_BYTES;
+  adc_digi_output_data_t *out = (adc_digi_output_data_t *)buf;
+  uint8_t ch = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    while (!(adcChanMask & (1 << ch))) ch = (ch + 1) & 7;
+    out[i].val = 0;
+    out[i].type1.channel = ch;
+    out[i].type1.data = analogLevel[ADC1_PINS[ch]] & 0xFFF;
+    ch = (ch + 1) & 7;
+  }
+  *out_length = n * SOC_ADC_DIGI_RESULT_BYTES;
+  return ESP_OK;
+}
+
+// Kalibrasi: kurva linear tipikal atten 11dB, sumber "default Vref"
+// (host tidak punya eFuse)
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten,
+                                             adc_bits_width_t bit_width, uint32_t default_vref,
+                                             esp_adc_cal_characteristics_t *chars) {
+  chars->adc_num = adc_num;
+  chars->atten = atten;
+  chars->bit_width = bit_width;
+  chars->coeff_a = 3150 - 142;   // mV sepanjang 0..4095
+  chars->coeff_b = 142;          // offset mV
+  chars->vref = default_vref;
+  return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t *chars) {
+  return chars->coeff_b + adc_reading * chars->coeff_a / 4095;
+}
+
+// Sama dengan arduino-esp32 2.x
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  const long run = inMax - inMin;
+  if (run == 0) return -1;
+  return (x - inMin) * (outMax - outMin) / run + outMin;
+}
+
+// ===== Memori / ESP =====
+bool psramFound() { return false; }
+void *ps_malloc(size_t size) { return nullptr; }
+
+void EspClass::restart() {
+  fprintf(stderr, "host: ESP.restart() dipanggil (t=%llu us)\n", (unsigned long long)nowUs);
+  exit(2);
+}
+
+// "Cycle" host (getCpuFreqMHz = 1000) = waktu virtual dalam ns + kerja
+// wall clock konteks pemanggil, jadi span ISR/render = kerja nyata dan
+// cpu% AudioProfiler = biaya host per detik audio virtual. Late/missed
+// tidak dihitung di host (lihat AudioProfiler::endIsr).
+uint32_t EspClass::getCycleCount() {
+  chargeCpu();
+  return (uint32_t)(nowUs * 1000 + *cpuClock);
+}
+
+// ===== Serial =====
+static bool quietLog = false;
+static bool lineStart = true;
+static uint64_t logOriginUs = 0;
+
+void hostSetQuiet(bool quiet) { quietLog = quiet; }
+void hostSetLogOriginUs(uint64_t us) { logOriginUs = us; }
+
+size_t HostSerial::write(const uint8_t *buf, size_t size) {
+  if (quietLog) return size;
+  for (size_t i = 0; i < size; i++) {
+    if (lineStart) {
+      fprintf(stderr, "[%9.3f] ", ((int64_t)nowUs - (int64_t)logOriginUs) / 1000.0);
+      lineStart = false;
+    }
+    fputc(buf[i], stderr);
+    if (buf[i] == '\n') lineStart = true;
+  }
+  return size;
+}
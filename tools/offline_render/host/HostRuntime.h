@@ -0,0 +1,45 @@
+#pragma once
+// Runtime host untuk offline_render: jam virtual, scheduler task
+// kooperatif (ucontext), pin/ADC/DAC virtual, timer hardware, dan hook
+// BLE. Firmware asli dikompilasi apa adanya terhadap shim di folder ini;
+// hanya runner (offline_render.cpp) yang memakai fungsi host* di bawah.
+//
+// Model waktu: waktu virtual hanya maju di antara tick timer (ISR sample).
+// Kode task jalan "seketika" (tanpa memakan waktu virtual), jadi output
+// deterministik dan bisa dirender jauh lebih cepat dari real time.
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// ===== Jam virtual =====
+uint64_t hostNowUs();
+void hostSetNowUs(uint64_t us);
+
+// ===== Scheduler =====
+// Jalankan semua task yang siap (bangun dari delay / ada event baru)
+// sampai tidak ada lagi yang bisa jalan pada waktu sekarang.
+void hostRunTasks();
+bool hostTasksPending();     // ada task yang perlu dijalankan sekarang
+uint64_t hostNextWakeUs();   // delay terdekat (UINT64_MAX kalau tidak ada)
+void hostSignal();           // tandai ada event (queue, notify, semaphore)
+
+// ===== Timer hardware (satu timer alarm, dipakai TimerDacSink) =====
+bool hostTimerActive();
+uint64_t hostTimerPeriodUs();
+void hostTimerFire();        // panggil ISR timer
+
+// ===== GPIO / ADC / DAC =====
+void hostSetDigital(uint8_t pin, bool level);
+void hostSetAnalog(uint8_t pin, uint16_t value);
+uint8_t hostDacValue(uint8_t pin);
+
+// ===== BLE: tulis ke characteristic seperti dari aplikasi =====
+bool hostBleWrite(const char *uuid, const uint8_t *data, size_t len);
+std::string hostBleRead(const char *uuid);
+
+// ===== Filesystem: root LittleFS = folder host =====
+void hostSetFsRoot(const std::string &dir);
+
+// ===== Log =====
+void hostSetQuiet(bool quiet);
+void hostSetLogOriginUs(uint64_t us);  // prefix waktu log relatif ke titik ini
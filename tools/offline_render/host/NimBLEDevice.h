@@ -0,0 +1,87 @@
+#pragma once
+// Shim NimBLE: tanpa radio. Characteristic yang dibuat firmware dicatat
+// per UUID supaya runner bisa memanggil onWrite/onRead asli lewat
+// hostBleWrite()/hostBleRead().
+#include <Arduino.h>
+#include <string>
+
+#define ESP_PWR_LVL_P9 7
+
+namespace NIMBLE_PROPERTY {
+enum : uint32_t {
+  READ = 0x0002,
+  WRITE_NR = 0x0004,
+  WRITE = 0x0008,
+  NOTIFY = 0x0010,
+  INDICATE = 0x0020,
+};
+}
+
+class NimBLEServer;
+class NimBLECharacteristic;
+
+class NimBLEServerCallbacks {
+public:
+  virtual ~NimBLEServerCallbacks() {}
+  virtual void onConnect(NimBLEServer *pServer) {}
+  virtual void onDisconnect(NimBLEServer *pServer) {}
+};
+
+class NimBLECharacteristicCallbacks {
+public:
+  virtual ~NimBLECharacteristicCallbacks() {}
+  virtual void onRead(NimBLECharacteristic *pCharacteristic) {}
+  virtual void onWrite(NimBLECharacteristic *pCharacteristic) {}
+};
+
+class NimBLECharacteristic {
+public:
+  NimBLECharacteristic(const char *uuid, uint32_t properties) : uuid(uuid), properties(properties) {}
+
+  std::string getValue() { return value; }
+  void setValue(const uint8_t *data, size_t len) { value.assign((const char *)data, len); }
+  void setValue(const std::string &v) { value = v; }
+  void setCallbacks(NimBLECharacteristicCallbacks *cb) { callbacks = cb; }
+  NimBLECharacteristicCallbacks *getCallbacks() { return callbacks; }
+  void notify();
+  const std::string &getUUIDString() const { return uuid; }
+
+private:
+  std::string uuid;
+  uint32_t properties;
+  std::string value;
+  NimBLECharacteristicCallbacks *callbacks = nullptr;
+};
+
+class NimBLEService {
+public:
+  NimBLECharacteristic *createCharacteristic(const char *uuid, uint32_t properties);
+  bool start() { return true; }
+};
+
+class NimBLEServer {
+public:
+  void setCallbacks(NimBLEServerCallbacks *cb) { callbacks = cb; }
+  NimBLEService *createService(const char *uuid) { return &service; }
+
+private:
+  NimBLEServerCallbacks *callbacks = nullptr;
+  NimBLEService service;
+};
+
+class NimBLEAdvertising {
+public:
+  void addServiceUUID(const char *uuid) {}
+  void setScanResponse(bool enable) {}
+  bool start() { return true; }
+};
+
+class NimBLEDevice {
+public:
+  static void init(const char *name) {}
+  static void setPower(int level) {}
+  static void setMTU(uint16_t mtu) {}
+  static NimBLEServer *createServer();
+  static NimBLEAdvertising *getAdvertising();
+  static bool startAdvertising() { return true; }
+};
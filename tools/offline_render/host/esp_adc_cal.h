@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include "driver/adc.h"
+
+// Kalibrasi ADC host: kurva linear tipikal ESP32 atten 11dB
+// (kode 0 ~ 142 mV, kode 4095 ~ 3150 mV)
+typedef enum {
+  ESP_ADC_CAL_VAL_EFUSE_VREF,
+  ESP_ADC_CAL_VAL_EFUSE_TP,
+  ESP_ADC_CAL_VAL_DEFAULT_VREF,
+} esp_adc_cal_value_t;
+
+typedef struct {
+  adc_unit_t adc_num;
+  adc_atten_t atten;
+  adc_bits_width_t bit_width;
+  uint32_t coeff_a;
+  uint32_t coeff_b;
+  uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten,
+                                             adc_bits_width_t bit_width, uint32_t default_vref,
+                                             esp_adc_cal_characteristics_t *chars);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t *chars);
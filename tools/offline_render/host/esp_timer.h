@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Waktu virtual (us), sama dengan micros()
+int64_t esp_timer_get_time();
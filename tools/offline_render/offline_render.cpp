@@ -0,0 +1,382 @@
+// Renderer offline di host (Linux): firmware asli (setup(), task ADC/BLE,
+// SystemManager rev/shift, AudioPlayer, DspChain, EffectMixer,
+// VolumeControl, TimerDacSink) dijalankan terhadap jam virtual dan shim
+// di tools/offline_render/host, diberi input dari trace bertimestamp, dan
+// setiap sample yang ditulis ISR ke DAC disimpan ke WAV 8-bit.
+//
+// Jam virtual hanya maju per periode ISR (25 us di 40 kHz), task jalan
+// kooperatif tanpa memakan waktu: render sama persis di setiap run dan
+// jauh lebih cepat dari real time. Cocok untuk A/B perubahan DSP (--compare)
+// dan baseline throughput render.
+//
+// Build dari root project, satu baris (ArduinoJson dari libdeps PlatformIO,
+// jadi jalankan `pio pkg install -e esp32dev` sekali):
+//   g++ -O2 -std=gnu++17 -Itools/offline_render/host -Iinclude -I.pio/libdeps/esp32dev/ArduinoJson/src
+//     tools/offline_render/offline_render.cpp tools/offline_render/host/*.cpp
+//     $(ls src/*.cpp | grep -v -e I2SDacSink -e OBD2Control) -o /tmp/offline_render
+//
+// Pakai:
+//   /tmp/offline_render <fs_root> <trace> <out.wav> [--duration ms] [--compare ref.wav] [-q]
+//
+// <fs_root> = isi LittleFS (mis. data/); disalin ke folder sementara
+// karena loader menulis balik file yang dinormalisasi.
+//
+// Format trace (satu event per baris, waktu ms sejak sample pertama):
+//   <ms> adc <0-4095>                 posisi throttle (raw ADC, dibaca lewat DMA)
+//   <ms> button <A|B|C> <down|up>     level tombol
+//   <ms> button <A|B|C> press [hold]  down lalu up setelah hold ms (default 100)
+//   <ms> ble <cmd> [val]              paket kontrol BLE (0xAA cmd val chk)
+//                                     cmd: hex atau gear_up, gear_down,
+//                                     rev_start, rev_stop, vol, play,
+//                                     auto_shift, reset_diag, status
+//   <ms> diag                         cetak laporan diagnostik BLE ke stdout
+//   <ms> end                          akhir render
+//   # komentar
+//
+// Exit code: 0 OK, 1 argumen/trace/IO salah, 4 --compare menemukan beda.
+
+#include <Arduino.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+#include "config.h"
+#include "BLEControl.h"
+
+void setup();
+void loop();
+
+namespace stdfs = std::filesystem;
+
+enum TraceKind { EV_ADC, EV_PIN, EV_BLE, EV_DIAG, EV_END };
+
+struct TraceEvent {
+  uint64_t timeUs;
+  TraceKind kind;
+  uint8_t pin;
+  uint16_t value;
+  uint8_t cmd;
+  uint32_t line;   // urutan di file: tie-break event dengan waktu sama
+};
+
+static const struct {
+  const char *name;
+  uint8_t cmd;
+} bleNames[] = {
+  {"gear_up", CMD_GEAR_UP},       {"gear_down", CMD_GEAR_DOWN},
+  {"rev_start", CMD_REV_START},   {"rev_stop", CMD_REV_STOP},
+  {"vol", CMD_VOL},               {"play", CMD_SET_AUDIO_PLAY},
+  {"auto_shift", CMD_TOGGLE_AUTO_SHIFT}, {"reset_diag", CMD_RESET_DIAG},
+  {"status", CMD_REQ_STATUS},
+};
+
+static bool parseButton(const std::string &s, uint8_t &pin) {
+  if (s == "A") pin = BUTTON_A_PIN;
+  else if (s == "B") pin = BUTTON_B_PIN;
+  else if (s == "C") pin = BUTTON_C_PIN;
+  else return false;
+  return true;
+}
+
+static bool parseBleCmd(const std::string &s, uint8_t &cmd) {
+  for (const auto &n : bleNames) {
+    if (s == n.name) {
+      cmd = n.cmd;
+      return true;
+    }
+  }
+  char *end = nullptr;
+  unsigned long v = strtoul(s.c_str(), &end, 0);
+  if (end == s.c_str() || *end || v > 0xFF) return false;
+  cmd = (uint8_t)v;
+  return true;
+}
+
+static bool loadTrace(const char *path, std::vector<TraceEvent> &events) {
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "❌ Trace tidak bisa dibuka: %s\n", path);
+    return false;
+  }
+
+  std::string raw;
+  uint32_t lineNo = 0;
+  while (std::getline(in, raw)) {
+    lineNo++;
+    size_t hash = raw.find('#');
+    if (hash != std::string::npos) raw.erase(hash);
+    std::istringstream ls(raw);
+    double ms;
+    std::string kind;
+    if (!(ls >> ms)) continue;  // baris kosong
+    if (!(ls >> kind) || ms < 0) goto bad;
+
+    {
+      TraceEvent ev{};
+      ev.timeUs = (uint64_t)(ms * 1000.0 + 0.5);
+      ev.line = lineNo;
+
+      if (kind == "adc") {
+        long v;
+        if (!(ls >> v) || v < 0 || v > 4095) goto bad;
+        ev.kind = EV_ADC;
+        ev.pin = THROTTLE_ADC_PIN;
+        ev.value = (uint16_t)v;
+        events.push_back(ev);
+      } else if (kind == "button") {
+        std::string name, action;
+        if (!(ls >> name >> action) || !parseButton(name, ev.pin)) goto bad;
+        ev.kind = EV_PIN;
+        if (action == "down" || action == "up") {
+          ev.value = (action == "down") ? LOW : HIGH;
+          events.push_back(ev);
+        } else if (action == "press") {
+          double hold = 100;
+          ls >> hold;
+          ev.value = LOW;
+          events.push_back(ev);
+          ev.timeUs += (uint64_t)(hold * 1000.0 + 0.5);
+          ev.value = HIGH;
+          events.push_back(ev);
+        } else {
+          goto bad;
+        }
+      } else if (kind == "ble") {
+        std::string cmd;
+        long val = 0;
+        if (!(ls >> cmd) || !parseBleCmd(cmd, ev.cmd)) goto bad;
+        ls >> val;
+        if (val < 0 || val > 255) goto bad;
+        ev.kind = EV_BLE;
+        ev.value = (uint16_t)val;
+        events.push_back(ev);
+      } else if (kind == "diag") {
+        ev.kind = EV_DIAG;
+        events.push_back(ev);
+      } else if (kind == "end") {
+        ev.kind = EV_END;
+        events.push_back(ev);
+      } else {
+        goto bad;
+      }
+    }
+    continue;
+
+  bad:
+    fprintf(stderr, "❌ %s:%u: event tidak dikenal: %s\n", path, lineNo, raw.c_str());
+    return false;
+  }
+
+  std::stable_sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b) {
+    return a.timeUs != b.timeUs ? a.timeUs < b.timeUs : a.line < b.line;
+  });
+  return true;
+}
+
+static void applyEvent(const TraceEvent &ev) {
+  switch (ev.kind) {
+  case EV_ADC:
+    hostSetAnalog(ev.pin, ev.value);
+    break;
+  case EV_PIN:
+    hostSetDigital(ev.pin, ev.value == HIGH);
+    break;
+  case EV_BLE: {
+    uint8_t pkt[4] = {0xAA, ev.cmd, (uint8_t)ev.value, (uint8_t)(ev.cmd ^ ev.value)};
+    hostBleWrite(CHARACTERISTIC_UUID, pkt, sizeof(pkt));
+    break;
+  }
+  case EV_DIAG:
+    printf("--- diag @ %.3f ms ---\n%s", ev.timeUs / 1000.0, hostBleRead(DIAG_CHARACTERISTIC_UUID).c_str());
+    break;
+  case EV_END:
+    break;
+  }
+}
+
+// ===== WAV 8-bit unsigned mono =====
+static void put16(std::vector<uint8_t> &b, uint16_t v) {
+  b.push_back(v & 0xFF);
+  b.push_back(v >> 8);
+}
+
+static void put32(std::vector<uint8_t> &b, uint32_t v) {
+  put16(b, v & 0xFFFF);
+  put16(b, v >> 16);
+}
+
+static bool writeWav(const char *path, const std::vector<uint8_t> &samples, uint32_t rate) {
+  std::vector<uint8_t> h;
+  h.insert(h.end(), {'R', 'I', 'F', 'F'});
+  put32(h, 36 + (uint32_t)samples.size());
+  h.insert(h.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  put32(h, 16);
+  put16(h, 1);        // PCM
+  put16(h, 1);        // mono
+  put32(h, rate);
+  put32(h, rate);     // byte rate
+  put16(h, 1);        // block align
+  put16(h, 8);        // bit per sample
+  h.insert(h.end(), {'d', 'a', 't', 'a'});
+  put32(h, (uint32_t)samples.size());
+
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  bool ok = fwrite(h.data(), 1, h.size(), f) == h.size() &&
+            fwrite(samples.data(), 1, samples.size(), f) == samples.size();
+  return fclose(f) == 0 && ok;
+}
+
+// Data chunk WAV 8-bit (format yang ditulis writeWav)
+static bool readWavData(const char *path, std::vector<uint8_t> &samples) {
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint8_t> all((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (all.size() < 44 || memcmp(all.data(), "RIFF", 4) || memcmp(all.data() + 36, "data", 4)) return false;
+  samples.assign(all.begin() + 44, all.end());
+  return true;
+}
+
+static uint32_t fnv1a(const std::vector<uint8_t> &data) {
+  uint32_t h = 2166136261u;
+  for (uint8_t b : data) h = (h ^ b) * 16777619u;
+  return h;
+}
+
+static int compareWav(const char *refPath, const std::vector<uint8_t> &out, uint32_t rate) {
+  std::vector<uint8_t> ref;
+  if (!readWavData(refPath, ref)) {
+    fprintf(stderr, "❌ Referensi bukan WAV 8-bit: %s\n", refPath);
+    return 1;
+  }
+  size_t n = std::min(ref.size(), out.size());
+  size_t diffCount = 0, first = SIZE_MAX;
+  int maxDiff = 0;
+  for (size_t i = 0; i < n; i++) {
+    int d = abs((int)out[i] - (int)ref[i]);
+    if (!d) continue;
+    if (first == SIZE_MAX) first = i;
+    diffCount++;
+    if (d > maxDiff) maxDiff = d;
+  }
+  if (ref.size() != out.size()) {
+    printf("compare: panjang beda (%zu vs %zu sample)\n", out.size(), ref.size());
+  }
+  if (first == SIZE_MAX && ref.size() == out.size()) {
+    printf("compare: identik dengan %s\n", refPath);
+    return 0;
+  }
+  if (first != SIZE_MAX) {
+    printf("compare: %zu sample beda, max |d|=%d, pertama di %.3f ms\n", diffCount, maxDiff,
+           first * 1000.0 / rate);
+  }
+  return 4;
+}
+
+static void loopTask(void *) {
+  for (;;) loop();
+}
+
+static void usage() {
+  fprintf(stderr, "usage: offline_render <fs_root> <trace> <out.wav> [--duration ms] [--compare ref.wav] [-q]\n");
+}
+
+int main(int argc, char **argv) {
+  const char *fsRoot = nullptr, *tracePath = nullptr, *outPath = nullptr, *refPath = nullptr;
+  double durationMs = -1;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--duration" && i + 1 < argc) durationMs = atof(argv[++i]);
+    else if (a == "--compare" && i + 1 < argc) refPath = argv[++i];
+    else if (a == "-q") quiet = true;
+    else if (!fsRoot) fsRoot = argv[i];
+    else if (!tracePath) tracePath = argv[i];
+    else if (!outPath) outPath = argv[i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+  if (!outPath) {
+    usage();
+    return 1;
+  }
+
+  std::vector<TraceEvent> events;
+  if (!loadTrace(tracePath, events)) return 1;
+
+  // Durasi: --duration, event "end", atau event terakhir + 1 detik
+  uint64_t endUs = events.empty() ? 1000000 : events.back().timeUs + 1000000;
+  for (const auto &ev : events) {
+    if (ev.kind == EV_END) {
+      endUs = ev.timeUs;
+      break;
+    }
+  }
+  if (durationMs >= 0) endUs = (uint64_t)(durationMs * 1000.0 + 0.5);
+
+  // Salin root LittleFS supaya data/ asli tidak ikut dinormalisasi ulang
+  std::error_code ec;
+  stdfs::path work = stdfs::temp_directory_path() / ("offline_render." + std::to_string(getpid()));
+  stdfs::remove_all(work, ec);
+  stdfs::copy(fsRoot, work, stdfs::copy_options::recursive, ec);
+  if (ec) {
+    fprintf(stderr, "❌ Gagal menyalin %s: %s\n", fsRoot, ec.message().c_str());
+    return 1;
+  }
+  hostSetFsRoot(work.string());
+  hostSetQuiet(quiet);
+
+  // Boot: setup() + loopTask seperti arduino-esp32 (core 1, prioritas 1)
+  setup();
+  xTaskCreatePinnedToCore(loopTask, "loopTask", 8192, nullptr, 1, nullptr, 1);
+  hostRunTasks();
+
+  if (!hostTimerActive()) {
+    fprintf(stderr, "❌ Timer audio tidak aktif setelah setup() (backend I2S tidak didukung)\n");
+    stdfs::remove_all(work, ec);
+    return 1;
+  }
+
+  // Sample n = ISR ke-n setelah setup; event trace relatif ke sample 0
+  const uint64_t period = hostTimerPeriodUs();
+  const uint32_t rate = (uint32_t)(1000000 / period);
+  const uint64_t t0 = hostNowUs();
+  hostSetLogOriginUs(t0);
+  const size_t total = (size_t)(endUs / period);
+  std::vector<uint8_t> out(total);
+  size_t next = 0;
+
+  auto wallStart = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < total; n++) {
+    uint64_t rel = (uint64_t)n * period;
+    hostSetNowUs(t0 + rel);
+    while (next < events.size() && events[next].timeUs <= rel) applyEvent(events[next++]);
+    hostRunTasks();
+    hostTimerFire();
+    hostRunTasks();
+    out[n] = hostDacValue(AUDIO_DAC_PIN);
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  // Laporan akhir (latency + profiler). Profiler di host: "cycle" = ns
+  // waktu virtual + kerja host (lihat EspClass::getCycleCount), jadi cpu% =
+  // waktu host per detik audio virtual; late/missed selalu 0 di host
+  printf("--- diag akhir ---\n%s", hostBleRead(DIAG_CHARACTERISTIC_UUID).c_str());
+  stdfs::remove_all(work, ec);
+
+  if (!writeWav(outPath, out, rate)) {
+    fprintf(stderr, "❌ Gagal menulis %s\n", outPath);
+    return 1;
+  }
+
+  double audioSec = (double)total / rate;
+  printf("render: %zu sample @ %lu Hz (%.2f s) dalam %.3f s wall = %.1fx real time\n", total,
+         (unsigned long)rate, audioSec, wall, wall > 0 ? audioSec / wall : 0.0);
+  printf("render: fnv1a=%08x -> %s\n", fnv1a(out), outPath);
+
+  return refPath ? compareWav(refPath, out, rate) : 0;
+}